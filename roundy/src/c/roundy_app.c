@@ -6,16 +6,49 @@
 #include "roundy_background_layer.h"
 #include "roundy_digit_layer.h"
 #include "roundy_palette.h"
+#include "roundy_profile.h"
 
 static Window *s_main_window;
 static RoundyBackgroundLayer *s_background_layer;
 static RoundyDigitLayer *s_digit_layer;
+static AppTimer *s_intro_timer;
 
 static void prv_tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_TICK);
   (void)units_changed;
   roundy_digit_layer_set_time(s_digit_layer, tick_time);
 }
 
+static void prv_intro_timer(void *context) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_INTRO_TIMER);
+  (void)context;
+  s_intro_timer = NULL;
+  /* the band sweeps the grid and re-flips the digit cells it passes over in the same steps */
+  const RoundyAnimDirection direction = roundy_anim_random_direction();
+  if (s_background_layer) {
+    roundy_digit_layer_set_backdrop_sweeping(s_digit_layer, true);
+    roundy_background_layer_start_diag_flip(s_background_layer, direction);
+  }
+  roundy_digit_layer_start_diag_flip(s_digit_layer, direction);
+  /* the band bitmaps and their timer are not needed for the first frame either */
+  roundy_digit_layer_start_prerender(s_digit_layer);
+}
+
+static void prv_sweep_done_handler(void *context) {
+  (void)context;
+  roundy_digit_layer_set_backdrop_sweeping(s_digit_layer, false);
+}
+
+/* The first frame is already the final face; the sweep band only starts once it is on screen so
+ * the first update stays free of rand/timer work.
+ */
+static void prv_first_frame_handler(void *context) {
+  (void)context;
+  ROUNDY_PROFILE_MARK(ROUNDY_PROFILE_SITE_FIRST_FRAME);
+  /* defer out of the render pass before marking layers dirty again */
+  s_intro_timer = app_timer_register(0, prv_intro_timer, NULL);
+}
+
 static void prv_window_load(Window *window) {
   Layer *root = window_get_root_layer(window);
   const GRect bounds = layer_get_bounds(root);
@@ -23,24 +56,26 @@ static void prv_window_load(Window *window) {
   s_background_layer = roundy_background_layer_create(bounds);
   if (s_background_layer) {
     layer_add_child(root, roundy_background_layer_get_layer(s_background_layer));
+    roundy_background_layer_set_sweep_done_handler(s_background_layer, prv_sweep_done_handler,
+                                                   NULL);
   }
 
   s_digit_layer = roundy_digit_layer_create(bounds);
   if (s_digit_layer) {
     layer_add_child(root, roundy_digit_layer_get_layer(s_digit_layer));
     roundy_digit_layer_refresh_time(s_digit_layer);
-    /* start a quick diagonal flip animation when the watchface appears */
-    const RoundyAnimDirection direction = roundy_anim_random_direction();
-    if (s_background_layer) {
-      roundy_background_layer_start_diag_flip(s_background_layer, direction);
-    }
-    roundy_digit_layer_start_diag_flip(s_digit_layer, direction);
+    roundy_digit_layer_set_first_frame_handler(s_digit_layer, prv_first_frame_handler, NULL);
   }
 }
 
 static void prv_window_unload(Window *window) {
   (void)window;
 
+  if (s_intro_timer) {
+    app_timer_cancel(s_intro_timer);
+    s_intro_timer = NULL;
+  }
+
   roundy_digit_layer_destroy(s_digit_layer);
   s_digit_layer = NULL;
 
@@ -49,6 +84,7 @@ static void prv_window_unload(Window *window) {
 }
 
 static void prv_init(void) {
+  ROUNDY_PROFILE_INIT();
   srand((unsigned)time(NULL));
 
   s_main_window = window_create();
@@ -64,6 +100,7 @@ static void prv_init(void) {
 
 static void prv_deinit(void) {
   tick_timer_service_unsubscribe();
+  ROUNDY_PROFILE_DEINIT();
   window_destroy(s_main_window);
   s_main_window = NULL;
 }
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <pebble.h>
+
+/* Rendering backend, picked at build time. `ROUNDY_BACKEND=pdc pebble build` defines
+ * ROUNDY_BACKEND_PDC: the grid, glyphs and sweep band are then drawn from the Pebble Draw Command
+ * resources that tools/roundy_pdc.py generates. Draw commands do not exist on aplite and would
+ * lose the dithered shades on the other 1-bit watch, so only colour platforms switch over.
+ */
+#if defined(ROUNDY_BACKEND_PDC) && defined(PBL_COLOR)
+#define ROUNDY_USE_PDC 1
+#endif
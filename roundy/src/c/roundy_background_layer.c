@@ -3,8 +3,12 @@
 #include <stdlib.h>
 
 #include "roundy_animation.h"
+#include "roundy_backend.h"
+#include "roundy_cell_kernel.h"
+#include "roundy_dither.h"
 #include "roundy_layout.h"
 #include "roundy_palette.h"
+#include "roundy_profile.h"
 
 typedef struct {
   AppTimer *progress_timer;
@@ -13,7 +17,17 @@ typedef struct {
   int16_t next_index;
   int16_t active_index;
   int16_t max_index;
+  /* index that has just returned from the band; only shaded on 1-bit platforms */
+  int16_t fade_index;
   bool active_index_flipped;
+  RoundyBackgroundLayerSweepHandler sweep_done_handler;
+  void *sweep_done_context;
+#if defined(ROUNDY_USE_PDC)
+  GDrawCommandImage *grid;
+  /* band frames for the running sweep's axis; only held while a sweep runs */
+  GDrawCommandSequence *sweep;
+  bool sweep_vertical;
+#endif
 } RoundyBackgroundLayerState;
 
 struct RoundyBackgroundLayer {
@@ -49,24 +63,109 @@ static inline int16_t prv_direction_index_for_cell(RoundyAnimDirection direction
 }
 
 static void prv_draw_background_cell(GContext *ctx, int cell_col, int cell_row, bool flipped) {
-  const GPoint origin = roundy_cell_origin(cell_col, cell_row);
+  /* the kernel leaves top/bottom rows empty for the trimmed diagonal look */
+  roundy_cell_draw_diagonal(ctx, roundy_cell_origin(cell_col, cell_row), flipped);
+}
+
+#if defined(PBL_BW)
+static inline uint8_t prv_dither_shade(const RoundyBackgroundLayerState *state,
+                                       int16_t cell_index) {
+  if (state->active_index_flipped && cell_index == state->active_index) {
+    return roundy_dither_cell_shade(ROUNDY_DITHER_BRIGHT, true);
+  }
+  if (cell_index == state->fade_index) {
+    return roundy_dither_cell_shade(ROUNDY_DITHER_FADE, false);
+  }
+  return roundy_dither_cell_shade(ROUNDY_DITHER_DIM, false);
+}
 
-  /* leave top/bottom rows empty for the trimmed diagonal look */
-  const int start_idx = 1;
-  const int end_idx = ROUNDY_CELL_SIZE - 2;
-  for (int idx = start_idx; idx <= end_idx; ++idx) {
-    const int x_idx = flipped ? (ROUNDY_CELL_SIZE - 1 - idx) : idx;
-    graphics_draw_pixel(ctx, GPoint(origin.x + x_idx, origin.y + idx));
+/* Rewrites every frame buffer row of the grid from the dither masks instead of plotting the
+ * diagonals pixel by pixel; this also covers the background fill.
+ */
+static bool prv_draw_dithered_grid(GContext *ctx, const RoundyBackgroundLayerState *state) {
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return false;
+  }
+
+  uint8_t *data = gbitmap_get_data(frame_buffer);
+  const uint16_t stride = gbitmap_get_bytes_per_row(frame_buffer);
+  uint8_t shades[ROUNDY_GRID_COLS];
+  for (int row = 0; row < ROUNDY_GRID_ROWS; ++row) {
+    for (int col = 0; col < ROUNDY_GRID_COLS; ++col) {
+      const int16_t cell_index = prv_direction_index_for_cell(state->direction, col, row);
+      shades[col] = prv_dither_shade(state, cell_index);
+    }
+    for (int y = 0; y < ROUNDY_CELL_SIZE; ++y) {
+      uint32_t *words = (uint32_t *)(data + (row * ROUNDY_CELL_SIZE + y) * stride);
+      roundy_dither_pack_row(words, stride / 4, shades, ROUNDY_GRID_COLS, y);
+    }
+  }
+
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return true;
+}
+#endif
+
+#if defined(ROUNDY_USE_PDC)
+static void prv_release_sweep(RoundyBackgroundLayerState *state) {
+  if (state->sweep) {
+    gdraw_command_sequence_destroy(state->sweep);
+    state->sweep = NULL;
+  }
+}
+
+/* Draws the pre-built grid and, during a sweep, the band frame; false leaves it to the
+ * procedural path.
+ */
+static bool prv_draw_pdc_grid(GContext *ctx, const RoundyBackgroundLayerState *state) {
+  const bool band = state->active_index_flipped && state->active_index >= 0;
+  if (!state->grid || (band && !state->sweep)) {
+    return false;
+  }
+
+  /* the procedural path plots hard pixels; antialiased strokes would blur the diagonals */
+  graphics_context_set_antialiased(ctx, false);
+  const GPoint origin = roundy_cell_origin(0, 0);
+  gdraw_command_image_draw(ctx, state->grid, origin);
+  if (band) {
+    /* frames are stored top-down / left-right; the reversed directions count from the end */
+    const int16_t frame_count = state->max_index + 1;
+    const bool reversed = (state->direction == ROUNDY_ANIM_DIR_BOTTOM_UP ||
+                           state->direction == ROUNDY_ANIM_DIR_RIGHT_LEFT);
+    const int16_t frame_index = reversed ? (frame_count - 1 - state->active_index)
+                                         : state->active_index;
+    GDrawCommandFrame *frame =
+        gdraw_command_sequence_get_frame_by_index(state->sweep, frame_index);
+    if (frame) {
+      gdraw_command_frame_draw(ctx, state->sweep, frame, origin);
+    }
   }
+  graphics_context_set_antialiased(ctx, true);
+  return true;
 }
+#endif
 
 static void prv_background_update_proc(Layer *layer, GContext *ctx) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_BACKGROUND_UPDATE);
   const GRect bounds = layer_get_bounds(layer);
   RoundyBackgroundLayerState *state = layer_get_data(layer);
 
+#if defined(PBL_BW)
+  if (state && prv_draw_dithered_grid(ctx, state)) {
+    return;
+  }
+#endif
+
   graphics_context_set_fill_color(ctx, roundy_palette_background_fill());
   graphics_fill_rect(ctx, bounds, 0, GCornerNone);
 
+#if defined(ROUNDY_USE_PDC)
+  if (state && prv_draw_pdc_grid(ctx, state)) {
+    return;
+  }
+#endif
+
   for (int row = 0; row < ROUNDY_GRID_ROWS; ++row) {
     for (int col = 0; col < ROUNDY_GRID_COLS; ++col) {
       bool flipped = false;
@@ -82,7 +181,18 @@ static void prv_background_update_proc(Layer *layer, GContext *ctx) {
   }
 }
 
+static void prv_sweep_done(RoundyBackgroundLayerState *state) {
+  ROUNDY_PROFILE_MARK(ROUNDY_PROFILE_SITE_SWEEP_DONE);
+#if defined(ROUNDY_USE_PDC)
+  prv_release_sweep(state);
+#endif
+  if (state->sweep_done_handler) {
+    state->sweep_done_handler(state->sweep_done_context);
+  }
+}
+
 static void prv_background_return_timer(void *ctx) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_BACKGROUND_RETURN_TIMER);
   Layer *layer = (Layer *)ctx;
   if (!layer) {
     return;
@@ -93,14 +203,20 @@ static void prv_background_return_timer(void *ctx) {
     return;
   }
 
+  /* the returning index fades out while the sweep is still moving on */
+  state->fade_index = state->progress_timer ? state->active_index : -1;
   state->active_index_flipped = false;
   state->active_index = -1;
   state->return_timer = NULL;
+  if (!state->progress_timer) {
+    prv_sweep_done(state);
+  }
 
   layer_mark_dirty(layer);
 }
 
 static void prv_background_progress_timer(void *ctx) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_BACKGROUND_PROGRESS_TIMER);
   Layer *layer = (Layer *)ctx;
   if (!layer) {
     return;
@@ -116,6 +232,8 @@ static void prv_background_progress_timer(void *ctx) {
     if (!state->return_timer) {
       state->active_index_flipped = false;
       state->active_index = -1;
+      state->fade_index = -1;
+      prv_sweep_done(state);
       layer_mark_dirty(layer);
     }
     return;
@@ -159,7 +277,16 @@ RoundyBackgroundLayer *roundy_background_layer_create(GRect frame) {
   layer->state->max_index = prv_direction_max_index(layer->state->direction);
   layer->state->next_index = 0;
   layer->state->active_index = -1;
+  layer->state->fade_index = -1;
   layer->state->active_index_flipped = false;
+  layer->state->sweep_done_handler = NULL;
+  layer->state->sweep_done_context = NULL;
+#if defined(ROUNDY_USE_PDC)
+  /* a missing resource leaves the procedural path in charge */
+  layer->state->grid = gdraw_command_image_create_with_resource(RESOURCE_ID_ROUNDY_GRID_PDC);
+  layer->state->sweep = NULL;
+  layer->state->sweep_vertical = false;
+#endif
 
   layer_set_update_proc(layer->layer, prv_background_update_proc);
   return layer;
@@ -181,6 +308,13 @@ void roundy_background_layer_destroy(RoundyBackgroundLayer *layer) {
         app_timer_cancel(state->return_timer);
         state->return_timer = NULL;
       }
+#if defined(ROUNDY_USE_PDC)
+      prv_release_sweep(state);
+      if (state->grid) {
+        gdraw_command_image_destroy(state->grid);
+        state->grid = NULL;
+      }
+#endif
     }
     layer_destroy(layer->layer);
   }
@@ -208,6 +342,8 @@ void roundy_background_layer_start_diag_flip(RoundyBackgroundLayer *layer,
     return;
   }
 
+  /* only a sweep that is still running leaves a band on screen to clear */
+  const bool was_running = (state->progress_timer || state->return_timer);
   if (state->progress_timer) {
     app_timer_cancel(state->progress_timer);
     state->progress_timer = NULL;
@@ -219,11 +355,36 @@ void roundy_background_layer_start_diag_flip(RoundyBackgroundLayer *layer,
 
   state->direction = direction;
   state->max_index = prv_direction_max_index(direction);
+#if defined(ROUNDY_USE_PDC)
+  const bool vertical = prv_direction_is_vertical(direction);
+  if (state->sweep && state->sweep_vertical != vertical) {
+    prv_release_sweep(state);
+  }
+  if (!state->sweep && state->grid) {
+    state->sweep = gdraw_command_sequence_create_with_resource(
+        vertical ? RESOURCE_ID_ROUNDY_SWEEP_ROWS_PDC : RESOURCE_ID_ROUNDY_SWEEP_COLS_PDC);
+    state->sweep_vertical = vertical;
+  }
+#endif
   state->next_index = 0;
   state->active_index = -1;
+  state->fade_index = -1;
   state->active_index_flipped = false;
 
-  layer_mark_dirty(layer->layer);
+  if (was_running) {
+    layer_mark_dirty(layer->layer);
+  }
   state->progress_timer = app_timer_register(ROUNDY_DIAG_ANIM_INITIAL_DELAY_MS,
                                              prv_background_progress_timer, layer->layer);
 }
+
+void roundy_background_layer_set_sweep_done_handler(RoundyBackgroundLayer *layer,
+                                                    RoundyBackgroundLayerSweepHandler handler,
+                                                    void *context) {
+  RoundyBackgroundLayerState *state = prv_get_state(layer);
+  if (!state) {
+    return;
+  }
+  state->sweep_done_handler = handler;
+  state->sweep_done_context = context;
+}
@@ -5,6 +5,7 @@
 #include "roundy_animation.h"
 
 typedef struct RoundyBackgroundLayer RoundyBackgroundLayer;
+typedef void (*RoundyBackgroundLayerSweepHandler)(void *context);
 
 RoundyBackgroundLayer *roundy_background_layer_create(GRect frame);
 void roundy_background_layer_destroy(RoundyBackgroundLayer *layer);
@@ -12,3 +13,7 @@ Layer *roundy_background_layer_get_layer(RoundyBackgroundLayer *layer);
 void roundy_background_layer_mark_dirty(RoundyBackgroundLayer *layer);
 void roundy_background_layer_start_diag_flip(RoundyBackgroundLayer *layer,
                                              RoundyAnimDirection direction);
+/* Called each time a sweep has fully returned to the idle grid. */
+void roundy_background_layer_set_sweep_done_handler(RoundyBackgroundLayer *layer,
+                                                    RoundyBackgroundLayerSweepHandler handler,
+                                                    void *context);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "roundy_layout.h"
+
+/* Unrolled per-cell kernels. Every cell carries one diagonal that skips the border pixels:
+ * (\) by default and (/) once flipped. ROUNDY_CELL_DIAG_INDICES expands X(idx) once for each
+ * pixel of that diagonal, so each kernel below is a straight run of constant-offset writes for
+ * the cell size this platform was built with.
+ */
+#if ROUNDY_CELL_PX == 6
+#define ROUNDY_CELL_DIAG_INDICES(X) X(1) X(2) X(3) X(4)
+#elif ROUNDY_CELL_PX == 7
+#define ROUNDY_CELL_DIAG_INDICES(X) X(1) X(2) X(3) X(4) X(5)
+#elif ROUNDY_CELL_PX == 8
+#define ROUNDY_CELL_DIAG_INDICES(X) X(1) X(2) X(3) X(4) X(5) X(6)
+#else
+#error "no cell kernel for this ROUNDY_CELL_PX"
+#endif
+
+/* x offset of the diagonal pixel on row idx */
+#define ROUNDY_CELL_DIAG_X(idx, flipped) ((flipped) ? (ROUNDY_CELL_PX - 1 - (idx)) : (idx))
+
+static inline void roundy_cell_draw_diagonal(GContext *ctx, GPoint origin, bool flipped) {
+#define ROUNDY_CELL_PIXEL_BACKSLASH(idx) \
+  graphics_draw_pixel(ctx, GPoint(origin.x + ROUNDY_CELL_DIAG_X(idx, false), origin.y + (idx)));
+#define ROUNDY_CELL_PIXEL_SLASH(idx) \
+  graphics_draw_pixel(ctx, GPoint(origin.x + ROUNDY_CELL_DIAG_X(idx, true), origin.y + (idx)));
+  if (flipped) {
+    ROUNDY_CELL_DIAG_INDICES(ROUNDY_CELL_PIXEL_SLASH)
+  } else {
+    ROUNDY_CELL_DIAG_INDICES(ROUNDY_CELL_PIXEL_BACKSLASH)
+  }
+#undef ROUNDY_CELL_PIXEL_BACKSLASH
+#undef ROUNDY_CELL_PIXEL_SLASH
+}
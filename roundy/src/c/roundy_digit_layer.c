@@ -5,13 +5,18 @@
 #include <time.h>
 
 #include "roundy_animation.h"
+#include "roundy_backend.h"
+#include "roundy_cell_kernel.h"
+#include "roundy_dither.h"
 #include "roundy_glyphs.h"
 #include "roundy_layout.h"
 #include "roundy_palette.h"
-#include <math.h>
+#include "roundy_profile.h"
 
-/* initial delay before starting the first animation frame (user requested value) */
+/* initial delay before starting the first animation frame; matches the background band */
 #define DIAG_START_DELAY_MS ROUNDY_DIAG_ANIM_INITIAL_DELAY_MS
+/* how long before the minute boundary the upcoming time is rendered off-screen */
+#define PRERENDER_LEAD_MS 2000
 
 static inline GColor prv_digit_stroke_color(bool flipped) {
   return flipped ? roundy_anim_bright_stroke() : roundy_anim_dim_stroke();
@@ -45,10 +50,55 @@ typedef struct {
   bool use_24h_time;
   AppTimer *anim_timer;
   RoundyAnimDirection direction;
+  /* index the flip band is on; -1 when settled (every digit cell flipped) */
   int16_t anim_index;
   int16_t anim_max;
+  RoundyDigitLayerFrameHandler first_frame_handler;
+  void *first_frame_context;
+  /* Off-screen copies of the settled digit band: the front one matches digits, the back one is
+   * rendered ahead of the next minute and swapped in by set_time when the prediction holds.
+   */
+  GBitmap *buffers[2];
+  uint8_t front_buffer;
+  bool front_valid;
+  bool back_valid;
+  bool back_use_24h_time;
+  int16_t back_digits[ROUNDY_DIGIT_COUNT];
+  AppTimer *prerender_timer;
+  /* the background sweep is on screen behind the band */
+  bool backdrop_sweeping;
+#if defined(ROUNDY_USE_PDC)
+  /* one frame per glyph in ROUNDY_GLYPHS order, settled look only */
+  GDrawCommandSequence *glyphs;
+#endif
+#if defined(ROUNDY_PROFILE)
+  uint32_t tick_ms;
+#endif
 } RoundyDigitLayerState;
 
+/* Paints one glyph cell into whatever target backs it (the frame buffer or an off-screen band).
+ * Targets that hold whole pre-built glyphs set paint_glyph instead and skip the cell walk.
+ */
+typedef struct {
+  void (*paint_cell)(void *target, int cell_col, int cell_row, bool flipped);
+  void (*paint_glyph)(void *target, int glyph_index, int cell_col, int cell_row);
+  void *target;
+  RoundyAnimDirection direction;
+  int16_t anim_index;
+} RoundyDigitPainter;
+
+#if defined(PBL_BW)
+/* 1-bit bands are built as one dither shade per cell and packed a row of words at a time */
+typedef struct {
+  uint8_t shades[ROUNDY_DIGIT_HEIGHT][ROUNDY_DIGIT_BAND_COLS];
+} RoundyDigitBuffer;
+#else
+typedef struct {
+  uint8_t *data;
+  uint16_t stride;
+} RoundyDigitBuffer;
+#endif
+
 struct RoundyDigitLayer {
   Layer *layer;
   RoundyDigitLayerState *state;
@@ -58,31 +108,80 @@ static inline RoundyDigitLayerState *prv_get_state(RoundyDigitLayer *layer) {
   return layer ? layer->state : NULL;
 }
 
-/* Draw a single cell. The diagonal inside the cell is interpolated between
- * the original (\) and the opposite (/) based on flipped state.
+/* Draw a single cell. The diagonal inside the cell is either the original (\) or,
+ * once flipped, the opposite (/).
  */
 static void prv_draw_digit_cell(GContext *ctx, int cell_col, int cell_row, bool flipped) {
   const GRect frame = roundy_cell_frame(cell_col, cell_row);
   graphics_fill_rect(ctx, frame, 0, GCornerNone);
+  /* the kernel skips the border pixels to leave the outer frame empty */
+  roundy_cell_draw_diagonal(ctx, frame.origin, flipped);
+}
+
+#if defined(PBL_BW)
+/* The dim stroke is plain black on 1-bit, so an unflipped digit cell would go dark; plot the
+ * dithered dim diagonal the background grid uses instead.
+ */
+static void prv_draw_dithered_digit_cell(GContext *ctx, int cell_col, int cell_row) {
+  const GRect frame = roundy_cell_frame(cell_col, cell_row);
+  graphics_fill_rect(ctx, frame, 0, GCornerNone);
+  graphics_context_set_stroke_color(ctx, roundy_anim_bright_stroke());
+  const uint8_t shade = roundy_dither_cell_shade(ROUNDY_DITHER_DIM, false);
+#define PRV_DITHERED_DIAG_PIXEL(idx)                                                      \
+  if (roundy_dither_cell_row_mask(shade, (idx)) & (1 << ROUNDY_CELL_DIAG_X(idx, false))) { \
+    graphics_draw_pixel(ctx, GPoint(frame.origin.x + ROUNDY_CELL_DIAG_X(idx, false),       \
+                                    frame.origin.y + (idx)));                              \
+  }
+  ROUNDY_CELL_DIAG_INDICES(PRV_DITHERED_DIAG_PIXEL)
+#undef PRV_DITHERED_DIAG_PIXEL
+}
+#endif
+
+static void prv_paint_context_cell(void *target, int cell_col, int cell_row, bool flipped) {
+  GContext *ctx = target;
+#if defined(PBL_BW)
+  if (!flipped) {
+    prv_draw_dithered_digit_cell(ctx, cell_col, cell_row);
+    return;
+  }
+#endif
+  graphics_context_set_stroke_color(ctx, prv_digit_stroke_color(flipped));
+  prv_draw_digit_cell(ctx, cell_col, cell_row, flipped);
+}
 
-  const int origin_x = frame.origin.x;
-  const int origin_y = frame.origin.y;
-  const float p = flipped ? 1.0f : 0.0f;
-  /* skip the border pixels to leave the outer frame empty */
-  const int start_idx = 1;
-  const int end_idx = ROUNDY_CELL_SIZE - 2;
-  for (int idx = start_idx; idx <= end_idx; ++idx) {
-    const int from_x = idx;
-    const int to_x = (ROUNDY_CELL_SIZE - 1 - idx);
-    const int x = origin_x + (int)roundf((1.0f - p) * from_x + p * to_x);
-    const int y = origin_y + idx;
-    graphics_draw_pixel(ctx, GPoint(x, y));
+#if defined(PBL_BW)
+/* Same look as prv_paint_context_cell: a flipped cell is the full bright diagonal on the black
+ * fill, an unflipped one the dim dither.
+ */
+static void prv_paint_buffer_cell(void *target, int cell_col, int cell_row, bool flipped) {
+  RoundyDigitBuffer *buffer = target;
+  buffer->shades[cell_row - ROUNDY_DIGIT_START_ROW][cell_col - ROUNDY_DIGIT_START_COL] =
+      roundy_dither_cell_shade(flipped ? ROUNDY_DITHER_BRIGHT : ROUNDY_DITHER_DIM, flipped);
+}
+#else
+/* Same pixels as prv_draw_digit_cell, written straight into the band bitmap. */
+static void prv_paint_buffer_cell(void *target, int cell_col, int cell_row, bool flipped) {
+  const RoundyDigitBuffer *buffer = target;
+  uint8_t *origin = buffer->data +
+                    (cell_row - ROUNDY_DIGIT_START_ROW) * ROUNDY_CELL_SIZE * buffer->stride +
+                    (cell_col - ROUNDY_DIGIT_START_COL) * ROUNDY_CELL_SIZE;
+
+  const uint8_t fill = roundy_palette_digit_fill().argb;
+  for (int y = 0; y < ROUNDY_CELL_SIZE; ++y) {
+    memset(origin + y * buffer->stride, fill, ROUNDY_CELL_SIZE);
   }
+
+  const uint8_t stroke = prv_digit_stroke_color(flipped).argb;
+#define PRV_BUFFER_DIAG_PIXEL(idx) \
+  origin[(idx) * buffer->stride + ROUNDY_CELL_DIAG_X(idx, flipped)] = stroke;
+  ROUNDY_CELL_DIAG_INDICES(PRV_BUFFER_DIAG_PIXEL)
+#undef PRV_BUFFER_DIAG_PIXEL
 }
+#endif
 
-static void prv_draw_glyph(GContext *ctx, const RoundyGlyph *glyph, int cell_col, int cell_row,
-                           const RoundyDigitLayerState *state) {
-  if (!glyph || !state) {
+static void prv_draw_glyph(const RoundyDigitPainter *painter, const RoundyGlyph *glyph,
+                           int cell_col, int cell_row) {
+  if (!glyph || !painter) {
     return;
   }
 
@@ -99,55 +198,235 @@ static void prv_draw_glyph(GContext *ctx, const RoundyGlyph *glyph, int cell_col
       const int absolute_col = cell_col + col;
       const int absolute_row = cell_row + row;
       const int16_t cell_index =
-          prv_direction_index_for_cell(state->direction, absolute_col, absolute_row);
-      const bool flipped = (state->anim_index >= cell_index);
-      graphics_context_set_stroke_color(ctx, prv_digit_stroke_color(flipped));
-      prv_draw_digit_cell(ctx, absolute_col, absolute_row, flipped);
+          prv_direction_index_for_cell(painter->direction, absolute_col, absolute_row);
+      /* the band turns the cells it is passing over back for one step */
+      const bool flipped = (painter->anim_index != cell_index);
+      painter->paint_cell(painter->target, absolute_col, absolute_row, flipped);
     }
   }
 }
 
-static void prv_draw_digit(GContext *ctx, int16_t digit, int cell_col, int cell_row,
-                           const RoundyDigitLayerState *state) {
-  if (!state || digit < ROUNDY_GLYPH_ZERO || digit > ROUNDY_GLYPH_NINE) {
+static void prv_paint_glyph(const RoundyDigitPainter *painter, int glyph_index, int cell_col,
+                            int cell_row) {
+  if (painter->paint_glyph) {
+    painter->paint_glyph(painter->target, glyph_index, cell_col, cell_row);
     return;
   }
-  prv_draw_glyph(ctx, &ROUNDY_GLYPHS[digit], cell_col, cell_row, state);
+  prv_draw_glyph(painter, &ROUNDY_GLYPHS[glyph_index], cell_col, cell_row);
 }
 
-static void prv_draw_colon(GContext *ctx, int cell_col, int cell_row,
-                           const RoundyDigitLayerState *state) {
-  if (!state) {
+static void prv_draw_digit(const RoundyDigitPainter *painter, int16_t digit, int cell_col,
+                           int cell_row) {
+  if (digit < ROUNDY_GLYPH_ZERO || digit > ROUNDY_GLYPH_NINE) {
     return;
   }
-  prv_draw_glyph(ctx, &ROUNDY_GLYPHS[ROUNDY_GLYPH_COLON], cell_col, cell_row, state);
+  prv_paint_glyph(painter, digit, cell_col, cell_row);
 }
 
-static void prv_digit_layer_update_proc(Layer *layer, GContext *ctx) {
-  RoundyDigitLayerState *state = layer_get_data(layer);
-  if (!state) {
-    return;
-  }
-
-  graphics_context_set_fill_color(ctx, roundy_palette_digit_fill());
-  graphics_context_set_stroke_color(ctx, prv_digit_stroke_color(false));
+static void prv_draw_colon(const RoundyDigitPainter *painter, int cell_col, int cell_row) {
+  prv_paint_glyph(painter, ROUNDY_GLYPH_COLON, cell_col, cell_row);
+}
 
+static void prv_draw_time(const RoundyDigitPainter *painter,
+                          const int16_t digits[ROUNDY_DIGIT_COUNT]) {
   int cell_col = ROUNDY_DIGIT_START_COL;
   const int cell_row = ROUNDY_DIGIT_START_ROW;
 
-  prv_draw_digit(ctx, state->digits[0], cell_col, cell_row, state);
+  prv_draw_digit(painter, digits[0], cell_col, cell_row);
   cell_col += ROUNDY_DIGIT_WIDTH + ROUNDY_DIGIT_GAP;
 
-  prv_draw_digit(ctx, state->digits[1], cell_col, cell_row, state);
+  prv_draw_digit(painter, digits[1], cell_col, cell_row);
   cell_col += ROUNDY_DIGIT_WIDTH + ROUNDY_DIGIT_GAP;
 
-  prv_draw_colon(ctx, cell_col, cell_row, state);
+  prv_draw_colon(painter, cell_col, cell_row);
   cell_col += ROUNDY_DIGIT_COLON_WIDTH + ROUNDY_DIGIT_GAP;
 
-  prv_draw_digit(ctx, state->digits[2], cell_col, cell_row, state);
+  prv_draw_digit(painter, digits[2], cell_col, cell_row);
   cell_col += ROUNDY_DIGIT_WIDTH + ROUNDY_DIGIT_GAP;
 
-  prv_draw_digit(ctx, state->digits[3], cell_col, cell_row, state);
+  prv_draw_digit(painter, digits[3], cell_col, cell_row);
+}
+
+#if defined(ROUNDY_USE_PDC)
+typedef struct {
+  GContext *ctx;
+  GDrawCommandSequence *glyphs;
+} RoundyDigitPdcTarget;
+
+static void prv_paint_pdc_glyph(void *target, int glyph_index, int cell_col, int cell_row) {
+  const RoundyDigitPdcTarget *pdc = target;
+  GDrawCommandFrame *frame = gdraw_command_sequence_get_frame_by_index(pdc->glyphs, glyph_index);
+  if (frame) {
+    gdraw_command_frame_draw(pdc->ctx, pdc->glyphs, frame, roundy_cell_origin(cell_col, cell_row));
+  }
+}
+#endif
+
+static void prv_digit_layer_update_proc(Layer *layer, GContext *ctx) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_DIGIT_UPDATE);
+  RoundyDigitLayerState *state = layer_get_data(layer);
+  if (!state) {
+    return;
+  }
+
+  /* the off-screen band only holds the settled look, so a running flip draws directly; the 1-bit
+   * band is opaque and carries the idle grid, so it would also paint over a running sweep */
+  const bool blit = state->front_valid && (state->anim_index < 0) &&
+                    PBL_IF_BW_ELSE(!state->backdrop_sweeping, true);
+  if (blit) {
+    /* glyph-free cells are transparent (colour) or carry the idle dithered grid (1-bit) */
+    graphics_context_set_compositing_mode(ctx, PBL_IF_COLOR_ELSE(GCompOpSet, GCompOpAssign));
+    graphics_draw_bitmap_in_rect(ctx, state->buffers[state->front_buffer],
+                                 roundy_digit_band_frame());
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+#if defined(ROUNDY_USE_PDC)
+  } else if (state->glyphs && (state->anim_index < 0)) {
+    RoundyDigitPdcTarget pdc = {.ctx = ctx, .glyphs = state->glyphs};
+    const RoundyDigitPainter painter = {
+        .paint_glyph = prv_paint_pdc_glyph,
+        .target = &pdc,
+    };
+    /* hard pixels like the procedural cells; antialiasing is on by default on colour */
+    graphics_context_set_antialiased(ctx, false);
+    prv_draw_time(&painter, state->digits);
+    graphics_context_set_antialiased(ctx, true);
+#endif
+  } else {
+    graphics_context_set_fill_color(ctx, roundy_palette_digit_fill());
+    graphics_context_set_stroke_color(ctx, prv_digit_stroke_color(false));
+
+    const RoundyDigitPainter painter = {
+        .paint_cell = prv_paint_context_cell,
+        .target = ctx,
+        .direction = state->direction,
+        .anim_index = state->anim_index,
+    };
+    prv_draw_time(&painter, state->digits);
+  }
+
+#if defined(ROUNDY_PROFILE)
+  if (state->tick_ms) {
+    roundy_profile_record(blit ? ROUNDY_PROFILE_SITE_TICK_FRAME_BLIT
+                               : ROUNDY_PROFILE_SITE_TICK_FRAME_DRAWN,
+                          state->tick_ms, roundy_profile_now_ms());
+    state->tick_ms = 0;
+  }
+#endif
+
+  if (state->first_frame_handler) {
+    const RoundyDigitLayerFrameHandler handler = state->first_frame_handler;
+    state->first_frame_handler = NULL;
+    handler(state->first_frame_context);
+  }
+}
+
+static void prv_time_to_digits(const struct tm *time_info, bool use_24h,
+                               int16_t digits[ROUNDY_DIGIT_COUNT]) {
+  int hour = time_info->tm_hour;
+  if (!use_24h) {
+    hour %= 12;
+    if (hour == 0) {
+      hour = 12;
+    }
+  }
+
+  digits[0] = (!use_24h && hour < 10) ? -1 : hour / 10;
+  digits[1] = hour % 10;
+  digits[2] = time_info->tm_min / 10;
+  digits[3] = time_info->tm_min % 10;
+}
+
+static void prv_destroy_buffers(RoundyDigitLayerState *state) {
+  for (int i = 0; i < 2; ++i) {
+    if (state->buffers[i]) {
+      gbitmap_destroy(state->buffers[i]);
+      state->buffers[i] = NULL;
+    }
+  }
+  state->front_valid = false;
+  state->back_valid = false;
+}
+
+/* Prerender timer callback: ctx is the Layer* whose data is RoundyDigitLayerState */
+static void prv_prerender_timer(void *ctx) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_DIGIT_PRERENDER);
+  Layer *layer = (Layer *)ctx;
+  if (!layer) {
+    return;
+  }
+  RoundyDigitLayerState *state = layer_get_data(layer);
+  if (!state) {
+    return;
+  }
+  state->prerender_timer = NULL;
+
+  GBitmap *back = state->buffers[state->front_buffer ^ 1];
+  if (!back) {
+    return;
+  }
+
+  time_t next_minute = time(NULL);
+  next_minute += 60 - (next_minute % 60);
+  const struct tm *time_info = localtime(&next_minute);
+  if (!time_info) {
+    return;
+  }
+
+  const bool use_24h = clock_is_24h_style();
+  prv_time_to_digits(time_info, use_24h, state->back_digits);
+  state->back_use_24h_time = use_24h;
+
+#if defined(PBL_BW)
+  /* 1-bit has no transparency: glyph-free cells carry the same idle grid the background dithers */
+  RoundyDigitBuffer buffer;
+  memset(buffer.shades, roundy_dither_cell_shade(ROUNDY_DITHER_DIM, false), sizeof(buffer.shades));
+#else
+  RoundyDigitBuffer buffer = {
+      .data = gbitmap_get_data(back),
+      .stride = gbitmap_get_bytes_per_row(back),
+  };
+  memset(buffer.data, 0, buffer.stride * ROUNDY_DIGIT_HEIGHT * ROUNDY_CELL_SIZE);
+#endif
+
+  const RoundyDigitPainter painter = {
+      .paint_cell = prv_paint_buffer_cell,
+      .target = &buffer,
+      .direction = state->direction,
+      .anim_index = -1,
+  };
+  prv_draw_time(&painter, state->back_digits);
+
+#if defined(PBL_BW)
+  uint8_t *data = gbitmap_get_data(back);
+  const uint16_t stride = gbitmap_get_bytes_per_row(back);
+  for (int y = 0; y < ROUNDY_DIGIT_HEIGHT * ROUNDY_CELL_SIZE; ++y) {
+    roundy_dither_pack_row((uint32_t *)(data + y * stride), stride / 4,
+                           buffer.shades[y / ROUNDY_CELL_SIZE], ROUNDY_DIGIT_BAND_COLS,
+                           y % ROUNDY_CELL_SIZE);
+  }
+#endif
+  state->back_valid = true;
+}
+
+static void prv_schedule_prerender(Layer *layer, RoundyDigitLayerState *state) {
+  if (state->prerender_timer) {
+    app_timer_cancel(state->prerender_timer);
+    state->prerender_timer = NULL;
+  }
+  if (!state->buffers[0]) {
+    return;
+  }
+
+  time_t now;
+  uint16_t now_ms;
+  time_ms(&now, &now_ms);
+  const int32_t into_minute_ms = (int32_t)(now % 60) * 1000 + now_ms;
+  const int32_t delay_ms = 60 * 1000 - into_minute_ms - PRERENDER_LEAD_MS;
+  /* too close to the boundary: this minute is drawn directly */
+  if (delay_ms <= 0) {
+    return;
+  }
+  state->prerender_timer = app_timer_register((uint32_t)delay_ms, prv_prerender_timer, layer);
 }
 
 RoundyDigitLayer *roundy_digit_layer_create(GRect frame) {
@@ -165,13 +444,29 @@ RoundyDigitLayer *roundy_digit_layer_create(GRect frame) {
   layer->state = layer_get_data(layer->layer);
   layer->state->use_24h_time = clock_is_24h_style();
   layer->state->direction = ROUNDY_ANIM_DIR_TOP_DOWN;
-  layer->state->anim_index = -1;
   layer->state->anim_max = prv_direction_max_index(layer->state->direction);
+  /* start settled so the very first frame is already the final face */
+  layer->state->anim_index = -1;
   layer->state->anim_timer = NULL;
+  layer->state->first_frame_handler = NULL;
+  layer->state->first_frame_context = NULL;
+  layer->state->prerender_timer = NULL;
+  layer->state->front_buffer = 0;
+  layer->state->front_valid = false;
+  layer->state->back_valid = false;
+  layer->state->backdrop_sweeping = false;
   for (int i = 0; i < ROUNDY_DIGIT_COUNT; ++i) {
     layer->state->digits[i] = -1;
   }
 
+  /* the off-screen bands only come in with roundy_digit_layer_start_prerender */
+  layer->state->buffers[0] = NULL;
+  layer->state->buffers[1] = NULL;
+#if defined(ROUNDY_USE_PDC)
+  /* a missing resource leaves the procedural path in charge */
+  layer->state->glyphs = gdraw_command_sequence_create_with_resource(RESOURCE_ID_ROUNDY_GLYPHS_PDC);
+#endif
+
   layer_set_update_proc(layer->layer, prv_digit_layer_update_proc);
   return layer;
 }
@@ -186,6 +481,19 @@ void roundy_digit_layer_destroy(RoundyDigitLayer *layer) {
       app_timer_cancel(state->anim_timer);
       state->anim_timer = NULL;
     }
+    if (state && state->prerender_timer) {
+      app_timer_cancel(state->prerender_timer);
+      state->prerender_timer = NULL;
+    }
+    if (state) {
+      prv_destroy_buffers(state);
+    }
+#if defined(ROUNDY_USE_PDC)
+    if (state && state->glyphs) {
+      gdraw_command_sequence_destroy(state->glyphs);
+      state->glyphs = NULL;
+    }
+#endif
     layer_destroy(layer->layer);
   }
   free(layer);
@@ -197,6 +505,7 @@ Layer *roundy_digit_layer_get_layer(RoundyDigitLayer *layer) {
 
 /* Animation timer callback: ctx is the Layer* whose data is RoundyDigitLayerState */
 static void prv_diag_anim_timer(void *ctx) {
+  ROUNDY_PROFILE_SCOPE(ROUNDY_PROFILE_SITE_DIGIT_ANIM_TIMER);
   Layer *layer = (Layer *)ctx;
   if (!layer) {
     return;
@@ -206,11 +515,10 @@ static void prv_diag_anim_timer(void *ctx) {
     return;
   }
 
-  if (state->anim_index < state->anim_max) {
-    state->anim_index++;
-  }
+  /* one more step after the last index lets the band leave the digits */
+  state->anim_index = (state->anim_index < state->anim_max) ? (state->anim_index + 1) : -1;
 
-  if (state->anim_index < state->anim_max) {
+  if (state->anim_index >= 0) {
     state->anim_timer =
         app_timer_register(ROUNDY_DIAG_ANIM_RETURN_DELAY_MS, prv_diag_anim_timer, layer);
   } else {
@@ -229,6 +537,8 @@ void roundy_digit_layer_start_diag_flip(RoundyDigitLayer *rdl, RoundyAnimDirecti
     return;
   }
 
+  /* the digits stay settled until the first step; only a running flip has a band to clear */
+  const bool was_running = (state->anim_index >= 0);
   if (state->anim_timer) {
     app_timer_cancel(state->anim_timer);
     state->anim_timer = NULL;
@@ -238,35 +548,22 @@ void roundy_digit_layer_start_diag_flip(RoundyDigitLayer *rdl, RoundyAnimDirecti
   state->anim_max = prv_direction_max_index(direction);
   state->anim_index = -1;
 
-  layer_mark_dirty(rdl->layer);
+  if (was_running) {
+    layer_mark_dirty(rdl->layer);
+  }
   state->anim_timer = app_timer_register(DIAG_START_DELAY_MS, prv_diag_anim_timer, rdl->layer);
 }
 
-void roundy_digit_layer_set_time(RoundyDigitLayer *layer, const struct tm *time_info) {
+/* from_tick: the redraw answers a minute tick and is profiled as tick-to-frame latency */
+static void prv_set_time(RoundyDigitLayer *layer, const struct tm *time_info, bool from_tick) {
   RoundyDigitLayerState *state = prv_get_state(layer);
   if (!state || !time_info) {
     return;
   }
 
   const bool use_24h = clock_is_24h_style();
-  int hour = time_info->tm_hour;
-  if (!use_24h) {
-    hour %= 12;
-    if (hour == 0) {
-      hour = 12;
-    }
-  }
-
-  int16_t new_digits[ROUNDY_DIGIT_COUNT] = {
-      hour / 10,
-      hour % 10,
-      time_info->tm_min / 10,
-      time_info->tm_min % 10,
-  };
-
-  if (!use_24h && hour < 10) {
-    new_digits[0] = -1;
-  }
+  int16_t new_digits[ROUNDY_DIGIT_COUNT];
+  prv_time_to_digits(time_info, use_24h, new_digits);
 
   bool changed = (state->use_24h_time != use_24h);
   for (int i = 0; i < ROUNDY_DIGIT_COUNT; ++i) {
@@ -280,9 +577,58 @@ void roundy_digit_layer_set_time(RoundyDigitLayer *layer, const struct tm *time_
     state->use_24h_time = use_24h;
   }
 
+  if (changed) {
+    /* a missed prediction (time-zone change, clock style switch, late timer) falls back to
+     * drawing directly until the next prerender */
+    const bool hit = state->back_valid && (state->back_use_24h_time == use_24h) &&
+                     (memcmp(state->back_digits, new_digits, sizeof(new_digits)) == 0);
+    if (hit) {
+      state->front_buffer ^= 1;
+    }
+    state->front_valid = hit;
+    state->back_valid = false;
+#if defined(ROUNDY_PROFILE)
+    if (from_tick) {
+      state->tick_ms = roundy_profile_now_ms();
+    }
+#else
+    (void)from_tick;
+#endif
+  }
+
   if (changed && layer->layer) {
     layer_mark_dirty(layer->layer);
   }
+  if (layer->layer) {
+    prv_schedule_prerender(layer->layer, state);
+  }
+}
+
+void roundy_digit_layer_start_prerender(RoundyDigitLayer *layer) {
+  RoundyDigitLayerState *state = prv_get_state(layer);
+  if (!state || state->buffers[0] || !layer->layer) {
+    return;
+  }
+
+#if defined(ROUNDY_USE_PDC)
+  /* the glyph frames replace the off-screen bands, so every frame is drawn directly */
+#else
+  /* without both buffers the layer simply keeps drawing every frame directly */
+  const GRect band = roundy_digit_band_frame();
+  for (int i = 0; i < 2; ++i) {
+    state->buffers[i] =
+        gbitmap_create_blank(band.size, PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+  }
+  if (!state->buffers[0] || !state->buffers[1]) {
+    prv_destroy_buffers(state);
+    return;
+  }
+  prv_schedule_prerender(layer->layer, state);
+#endif
+}
+
+void roundy_digit_layer_set_time(RoundyDigitLayer *layer, const struct tm *time_info) {
+  prv_set_time(layer, time_info, true);
 }
 
 void roundy_digit_layer_refresh_time(RoundyDigitLayer *layer) {
@@ -291,7 +637,18 @@ void roundy_digit_layer_refresh_time(RoundyDigitLayer *layer) {
   if (!time_info) {
     return;
   }
-  roundy_digit_layer_set_time(layer, time_info);
+  prv_set_time(layer, time_info, false);
+}
+
+void roundy_digit_layer_set_first_frame_handler(RoundyDigitLayer *layer,
+                                                RoundyDigitLayerFrameHandler handler,
+                                                void *context) {
+  RoundyDigitLayerState *state = prv_get_state(layer);
+  if (!state) {
+    return;
+  }
+  state->first_frame_handler = handler;
+  state->first_frame_context = context;
 }
 
 void roundy_digit_layer_force_redraw(RoundyDigitLayer *layer) {
@@ -299,3 +656,11 @@ void roundy_digit_layer_force_redraw(RoundyDigitLayer *layer) {
     layer_mark_dirty(layer->layer);
   }
 }
+
+void roundy_digit_layer_set_backdrop_sweeping(RoundyDigitLayer *layer, bool sweeping) {
+  RoundyDigitLayerState *state = prv_get_state(layer);
+  if (!state) {
+    return;
+  }
+  state->backdrop_sweeping = sweeping;
+}
@@ -5,11 +5,23 @@
 #include "roundy_animation.h"
 
 typedef struct RoundyDigitLayer RoundyDigitLayer;
+typedef void (*RoundyDigitLayerFrameHandler)(void *context);
 
 RoundyDigitLayer *roundy_digit_layer_create(GRect frame);
 void roundy_digit_layer_destroy(RoundyDigitLayer *layer);
 Layer *roundy_digit_layer_get_layer(RoundyDigitLayer *layer);
+/* For the minute tick; refresh_time covers every other caller (e.g. window load). */
 void roundy_digit_layer_set_time(RoundyDigitLayer *layer, const struct tm *time);
 void roundy_digit_layer_refresh_time(RoundyDigitLayer *layer);
 void roundy_digit_layer_force_redraw(RoundyDigitLayer *layer);
+/* Allocates the off-screen digit bands and starts rendering each next minute ahead of its tick.
+ * Until then (and on PDC builds) every frame is drawn directly. */
+void roundy_digit_layer_start_prerender(RoundyDigitLayer *layer);
 void roundy_digit_layer_start_diag_flip(RoundyDigitLayer *layer, RoundyAnimDirection direction);
+/* Called once, right after the next update proc has finished drawing. */
+void roundy_digit_layer_set_first_frame_handler(RoundyDigitLayer *layer,
+                                                RoundyDigitLayerFrameHandler handler,
+                                                void *context);
+/* Whether the background sweep is running behind the digits; while it is, 1-bit builds draw the
+ * digits directly instead of blitting the opaque pre-rendered band over it. */
+void roundy_digit_layer_set_backdrop_sweeping(RoundyDigitLayer *layer, bool sweeping);
@@ -0,0 +1,58 @@
+#include "roundy_dither.h"
+
+#if defined(PBL_BW)
+
+#if ROUNDY_CELL_PX != 6
+#error "dither masks are laid out for 6 px cells"
+#endif
+
+/* Per shade (level << 1 | flipped), the bits of each of the 6 cell rows. The diagonal runs over
+ * rows 1..4 and its pixels light up in 1-D Bayer order 1, 3, 2, 4 as the level rises.
+ */
+static const uint8_t s_cell_masks[ROUNDY_DITHER_LEVEL_COUNT * 2][ROUNDY_CELL_PX] = {
+  /* off */
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  /* quarter */
+  {0x00, 0x02, 0x00, 0x00, 0x00, 0x00},
+  {0x00, 0x10, 0x00, 0x00, 0x00, 0x00},
+  /* half */
+  {0x00, 0x02, 0x00, 0x08, 0x00, 0x00},
+  {0x00, 0x10, 0x00, 0x04, 0x00, 0x00},
+  /* three quarters */
+  {0x00, 0x02, 0x04, 0x08, 0x00, 0x00},
+  {0x00, 0x10, 0x08, 0x04, 0x00, 0x00},
+  /* full */
+  {0x00, 0x02, 0x04, 0x08, 0x10, 0x00},
+  {0x00, 0x10, 0x08, 0x04, 0x02, 0x00},
+};
+
+uint8_t roundy_dither_cell_row_mask(uint8_t cell_shade, int y) {
+  return s_cell_masks[cell_shade][y];
+}
+
+void roundy_dither_pack_row(uint32_t *words, int word_count, const uint8_t *cell_shades,
+                            int cell_count, int y) {
+  uint32_t acc = 0;
+  int bits = 0;
+  int word = 0;
+  for (int cell = 0; cell < cell_count && word < word_count; ++cell) {
+    const uint32_t mask = s_cell_masks[cell_shades[cell]][y];
+    acc |= mask << bits;
+    bits += ROUNDY_CELL_PX;
+    if (bits >= 32) {
+      words[word++] = acc;
+      bits -= 32;
+      /* carry the part of this cell that spilled past the word boundary */
+      acc = bits ? (mask >> (ROUNDY_CELL_PX - bits)) : 0;
+    }
+  }
+  if (bits && word < word_count) {
+    words[word++] = acc;
+  }
+  while (word < word_count) {
+    words[word++] = 0;
+  }
+}
+
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "roundy_layout.h"
+
+/* Ordered-dither shades for the 1-bit platforms, where the dim and bright strokes would
+ * otherwise both collapse to plain black/white. A shade level picks how many pixels of a cell's
+ * diagonal are lit, in 1-D Bayer order; the resulting cell masks are packed straight into
+ * 1-bit frame buffer rows a word at a time.
+ */
+
+typedef enum {
+  ROUNDY_DITHER_OFF = 0,
+  ROUNDY_DITHER_QUARTER,
+  ROUNDY_DITHER_HALF,
+  ROUNDY_DITHER_THREE_QUARTERS,
+  ROUNDY_DITHER_FULL,
+  ROUNDY_DITHER_LEVEL_COUNT,
+  /* shade of the idle grid */
+  ROUNDY_DITHER_DIM = ROUNDY_DITHER_HALF,
+  /* shade of the band index that has just returned */
+  ROUNDY_DITHER_FADE = ROUNDY_DITHER_THREE_QUARTERS,
+  /* shade of the active band */
+  ROUNDY_DITHER_BRIGHT = ROUNDY_DITHER_FULL,
+} RoundyDitherLevel;
+
+/* One cell's shade: dither level plus diagonal orientation (\ or, once flipped, /). */
+static inline uint8_t roundy_dither_cell_shade(RoundyDitherLevel level, bool flipped) {
+  return (uint8_t)((level << 1) | (flipped ? 1 : 0));
+}
+
+/* Lit pixels of row `y` (0..ROUNDY_CELL_SIZE-1) of one cell, leftmost pixel in bit 0; for code
+ * that plots a shaded cell through the graphics context instead of packing rows.
+ */
+uint8_t roundy_dither_cell_row_mask(uint8_t cell_shade, int y);
+
+/* Packs pixel row `y` (0..ROUNDY_CELL_SIZE-1) of a run of cells into 1-bit words, leftmost pixel
+ * in the least significant bit. `words` must be 32-bit aligned (frame buffer and blank bitmap
+ * rows are); words past the last cell are cleared.
+ */
+void roundy_dither_pack_row(uint32_t *words, int word_count, const uint8_t *cell_shades,
+                            int cell_count, int y);
@@ -2,24 +2,66 @@
 
 #include <pebble.h>
 
+/* Cell size and grid are picked per platform at compile time so the grid covers the whole
+ * screen: 6 px on the 144x168 watches, 7 px on chalk (180x180, the outer ring is masked by
+ * the round display anyway) and 8 px on emery (200x228). ROUNDY_CELL_PX is a macro so the
+ * cell kernels in roundy_cell_kernel.h can be selected by the preprocessor.
+ */
+#if defined(PBL_PLATFORM_EMERY)
+#define ROUNDY_CELL_PX 8
+#elif defined(PBL_PLATFORM_CHALK)
+#define ROUNDY_CELL_PX 7
+#else
+#define ROUNDY_CELL_PX 6
+#endif
+
 enum {
+#if defined(PBL_PLATFORM_EMERY)
+  ROUNDY_GRID_COLS = 26,
+  ROUNDY_GRID_ROWS = 28,
+  ROUNDY_GRID_ORIGIN_X = -4,
+  ROUNDY_GRID_ORIGIN_Y = 2,
+  ROUNDY_DIGIT_START_COL = 2,
+  ROUNDY_DIGIT_START_ROW = 10,
+#elif defined(PBL_PLATFORM_CHALK)
+  ROUNDY_GRID_COLS = 26,
+  ROUNDY_GRID_ROWS = 26,
+  ROUNDY_GRID_ORIGIN_X = -1,
+  ROUNDY_GRID_ORIGIN_Y = -1,
+  ROUNDY_DIGIT_START_COL = 2,
+  ROUNDY_DIGIT_START_ROW = 8,
+#else
   ROUNDY_GRID_COLS = 24,
   ROUNDY_GRID_ROWS = 28,
-  ROUNDY_CELL_SIZE = 6,
+  ROUNDY_GRID_ORIGIN_X = 0,
+  ROUNDY_GRID_ORIGIN_Y = 0,
+  ROUNDY_DIGIT_START_COL = 1,
+  ROUNDY_DIGIT_START_ROW = 10,
+#endif
+  ROUNDY_CELL_SIZE = ROUNDY_CELL_PX,
   ROUNDY_DIGIT_WIDTH = 4,
   ROUNDY_DIGIT_HEIGHT = 9,
   ROUNDY_DIGIT_COLON_WIDTH = 2,
   ROUNDY_DIGIT_COUNT = 4,
   ROUNDY_DIGIT_GAP = 1,
-  ROUNDY_DIGIT_START_COL = 1,
-  ROUNDY_DIGIT_START_ROW = 10,
+  /* cells spanned by HH:MM including the gaps */
+  ROUNDY_DIGIT_BAND_COLS = ROUNDY_DIGIT_COUNT * (ROUNDY_DIGIT_WIDTH + ROUNDY_DIGIT_GAP) +
+                           ROUNDY_DIGIT_COLON_WIDTH,
 };
 
 static inline GPoint roundy_cell_origin(int cell_col, int cell_row) {
-  return GPoint(cell_col * ROUNDY_CELL_SIZE, cell_row * ROUNDY_CELL_SIZE);
+  return GPoint(ROUNDY_GRID_ORIGIN_X + cell_col * ROUNDY_CELL_SIZE,
+                ROUNDY_GRID_ORIGIN_Y + cell_row * ROUNDY_CELL_SIZE);
 }
 
 static inline GRect roundy_cell_frame(int cell_col, int cell_row) {
-  return GRect(cell_col * ROUNDY_CELL_SIZE, cell_row * ROUNDY_CELL_SIZE,
+  return GRect(ROUNDY_GRID_ORIGIN_X + cell_col * ROUNDY_CELL_SIZE,
+               ROUNDY_GRID_ORIGIN_Y + cell_row * ROUNDY_CELL_SIZE,
                ROUNDY_CELL_SIZE, ROUNDY_CELL_SIZE);
 }
+
+static inline GRect roundy_digit_band_frame(void) {
+  const GPoint origin = roundy_cell_origin(ROUNDY_DIGIT_START_COL, ROUNDY_DIGIT_START_ROW);
+  return GRect(origin.x, origin.y,
+               ROUNDY_DIGIT_BAND_COLS * ROUNDY_CELL_SIZE, ROUNDY_DIGIT_HEIGHT * ROUNDY_CELL_SIZE);
+}
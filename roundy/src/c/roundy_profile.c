@@ -0,0 +1,109 @@
+#include "roundy_profile.h"
+
+#if defined(ROUNDY_PROFILE)
+
+typedef struct {
+  uint32_t start_ms;
+  uint16_t duration_ms;
+  uint8_t site;
+} RoundyProfileSample;
+
+enum {
+  ROUNDY_PROFILE_MILESTONE_COUNT =
+      ROUNDY_PROFILE_SITE_SWEEP_DONE - ROUNDY_PROFILE_SITE_FIRST_FRAME + 1,
+};
+
+static RoundyProfileSample s_samples[ROUNDY_PROFILE_CAPACITY];
+/* Milestones sit outside the ring so a long run never pushes them out; the first occurrence of
+ * each is kept for the whole launch and repeated at the top of every dump.
+ */
+static RoundyProfileSample s_milestones[ROUNDY_PROFILE_MILESTONE_COUNT];
+static bool s_milestone_set[ROUNDY_PROFILE_MILESTONE_COUNT];
+static uint16_t s_next;
+static uint16_t s_count;
+static uint32_t s_dropped;
+static uint32_t s_launch_ms;
+
+uint32_t roundy_profile_now_ms(void) {
+  time_t seconds;
+  uint16_t millis;
+  time_ms(&seconds, &millis);
+  return (uint32_t)seconds * 1000u + millis;
+}
+
+void roundy_profile_record(RoundyProfileSite site, uint32_t start_ms, uint32_t end_ms) {
+  const uint32_t duration = end_ms - start_ms;
+  RoundyProfileSample *sample = &s_samples[s_next];
+  sample->start_ms = start_ms;
+  sample->duration_ms = (duration > UINT16_MAX) ? UINT16_MAX : (uint16_t)duration;
+  sample->site = (uint8_t)site;
+
+  s_next = (uint16_t)((s_next + 1) % ROUNDY_PROFILE_CAPACITY);
+  if (s_count < ROUNDY_PROFILE_CAPACITY) {
+    s_count++;
+  } else {
+    s_dropped++;
+  }
+}
+
+/* Lines are parsed by tools/profile_histogram.py; keep the format in sync. */
+void roundy_profile_dump(void) {
+  const uint16_t first = (uint16_t)((s_next + ROUNDY_PROFILE_CAPACITY - s_count) %
+                                    ROUNDY_PROFILE_CAPACITY);
+  APP_LOG(APP_LOG_LEVEL_INFO, "prof-begin %u %lu", (unsigned)s_count, (unsigned long)s_dropped);
+  for (int i = 0; i < ROUNDY_PROFILE_MILESTONE_COUNT; ++i) {
+    if (s_milestone_set[i]) {
+      APP_LOG(APP_LOG_LEVEL_INFO, "prof %u %lu %u", (unsigned)s_milestones[i].site,
+              (unsigned long)s_milestones[i].start_ms, (unsigned)s_milestones[i].duration_ms);
+    }
+  }
+  for (uint16_t i = 0; i < s_count; ++i) {
+    const RoundyProfileSample *sample = &s_samples[(first + i) % ROUNDY_PROFILE_CAPACITY];
+    APP_LOG(APP_LOG_LEVEL_INFO, "prof %u %lu %u", (unsigned)sample->site,
+            (unsigned long)sample->start_ms, (unsigned)sample->duration_ms);
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "prof-end");
+
+  s_next = 0;
+  s_count = 0;
+  s_dropped = 0;
+}
+
+void roundy_profile_mark(RoundyProfileSite site) {
+  const int slot = (int)site - ROUNDY_PROFILE_SITE_FIRST_FRAME;
+  if (slot < 0 || slot >= ROUNDY_PROFILE_MILESTONE_COUNT || s_milestone_set[slot]) {
+    return;
+  }
+  const uint32_t duration = roundy_profile_now_ms() - s_launch_ms;
+  s_milestones[slot] = (RoundyProfileSample){
+      .start_ms = s_launch_ms,
+      .duration_ms = (duration > UINT16_MAX) ? UINT16_MAX : (uint16_t)duration,
+      .site = (uint8_t)site,
+  };
+  s_milestone_set[slot] = true;
+}
+
+static void prv_tap_handler(AccelAxisType axis, int32_t direction) {
+  (void)axis;
+  (void)direction;
+  roundy_profile_dump();
+}
+
+void roundy_profile_init(void) {
+  s_launch_ms = roundy_profile_now_ms();
+  s_next = 0;
+  s_count = 0;
+  s_dropped = 0;
+  for (int i = 0; i < ROUNDY_PROFILE_MILESTONE_COUNT; ++i) {
+    s_milestone_set[i] = false;
+  }
+  /* flick the wrist to dump the buffer to `pebble logs` */
+  accel_tap_service_subscribe(prv_tap_handler);
+}
+
+void roundy_profile_deinit(void) {
+  accel_tap_service_unsubscribe();
+  roundy_profile_dump();
+}
+
+#endif
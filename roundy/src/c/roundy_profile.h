@@ -0,0 +1,73 @@
+#pragma once
+
+#include <pebble.h>
+
+/* Compile-time optional instrumentation. Build with ROUNDY_PROFILE defined
+ * (`ROUNDY_PROFILE=1 pebble build`) to timestamp update procs, timers and the
+ * tick handler into a static ring buffer; otherwise every macro below expands
+ * to nothing.
+ */
+
+typedef enum {
+  ROUNDY_PROFILE_SITE_BACKGROUND_UPDATE = 0,
+  ROUNDY_PROFILE_SITE_DIGIT_UPDATE,
+  ROUNDY_PROFILE_SITE_BACKGROUND_PROGRESS_TIMER,
+  ROUNDY_PROFILE_SITE_BACKGROUND_RETURN_TIMER,
+  ROUNDY_PROFILE_SITE_DIGIT_ANIM_TIMER,
+  ROUNDY_PROFILE_SITE_TICK,
+  /* Milestones: duration is the time elapsed since main(); only the first of each is kept, outside
+   * the ring (keep them contiguous, see roundy_profile.c). */
+  ROUNDY_PROFILE_SITE_FIRST_FRAME,
+  ROUNDY_PROFILE_SITE_SWEEP_DONE,
+  ROUNDY_PROFILE_SITE_DIGIT_PRERENDER,
+  /* Tick-to-frame latency: duration runs from set_time to the end of the update proc. */
+  ROUNDY_PROFILE_SITE_TICK_FRAME_DRAWN,
+  ROUNDY_PROFILE_SITE_TICK_FRAME_BLIT,
+  ROUNDY_PROFILE_SITE_INTRO_TIMER,
+  ROUNDY_PROFILE_SITE_COUNT,
+} RoundyProfileSite;
+
+enum {
+  /* Number of samples kept before the oldest ones are overwritten. */
+  ROUNDY_PROFILE_CAPACITY = 128,
+};
+
+#if defined(ROUNDY_PROFILE)
+
+typedef struct {
+  uint32_t start_ms;
+  RoundyProfileSite site;
+} RoundyProfileScope;
+
+uint32_t roundy_profile_now_ms(void);
+void roundy_profile_init(void);
+void roundy_profile_deinit(void);
+void roundy_profile_record(RoundyProfileSite site, uint32_t start_ms, uint32_t end_ms);
+void roundy_profile_dump(void);
+void roundy_profile_mark(RoundyProfileSite site);
+
+static inline RoundyProfileScope roundy_profile_scope_begin(RoundyProfileSite site) {
+  return (RoundyProfileScope){.start_ms = roundy_profile_now_ms(), .site = site};
+}
+
+static inline void roundy_profile_scope_end(RoundyProfileScope *scope) {
+  roundy_profile_record(scope->site, scope->start_ms, roundy_profile_now_ms());
+}
+
+/* Records the enclosing block, early returns included. */
+#define ROUNDY_PROFILE_SCOPE(site)                                             \
+  RoundyProfileScope roundy_profile_scope_                                     \
+      __attribute__((cleanup(roundy_profile_scope_end), unused)) =             \
+          roundy_profile_scope_begin(site)
+#define ROUNDY_PROFILE_INIT() roundy_profile_init()
+#define ROUNDY_PROFILE_DEINIT() roundy_profile_deinit()
+#define ROUNDY_PROFILE_MARK(site) roundy_profile_mark(site)
+
+#else
+
+#define ROUNDY_PROFILE_SCOPE(site) ((void)0)
+#define ROUNDY_PROFILE_INIT() ((void)0)
+#define ROUNDY_PROFILE_DEINIT() ((void)0)
+#define ROUNDY_PROFILE_MARK(site) ((void)0)
+
+#endif
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""Build and run the face on the host against the stub SDK in this directory.
+
+runtime.c fakes the layer tree, timers, minute ticks and a frame buffer on a
+simulated clock, so the face can be rendered and timed without the emulator:
+
+    tools/host/host.py render emery -o emery.png        # face after 90 s
+    tools/host/host.py render chalk --ms 1500 --pdc     # mid intro sweep, PDC backend
+    tools/host/host.py bench aplite --ref HEAD~3        # update proc costs, then vs before
+    tools/host/host.py startup basalt --ref HEAD~3      # first frame and intro milestones
+    tools/host/host.py ticks aplite                     # tick-to-frame latency, blit vs drawn
+    tools/host/host.py insns basalt                     # cell kernel vs loop
+
+--ref builds src/c from another commit (via git archive) so before/after
+numbers come from the same harness. Timings are host -O2 wall clock, useful
+for comparing two trees, not as watch figures.
+"""
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+
+HOST_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.abspath(os.path.join(HOST_DIR, '..', '..'))
+
+# keep in sync with targetPlatforms in package.json
+PLATFORMS = {
+    'aplite': {'size': (144, 168), 'defines': ['PBL_BW', 'PBL_PLATFORM_APLITE'], 'tag': None},
+    'basalt': {'size': (144, 168), 'defines': ['PBL_COLOR', 'PBL_PLATFORM_BASALT'], 'tag': ''},
+    'chalk': {'size': (180, 180), 'defines': ['PBL_COLOR', 'PBL_PLATFORM_CHALK'],
+              'tag': '~chalk'},
+    'diorite': {'size': (144, 168), 'defines': ['PBL_BW', 'PBL_PLATFORM_DIORITE'], 'tag': None},
+    'emery': {'size': (200, 228), 'defines': ['PBL_COLOR', 'PBL_PLATFORM_EMERY'],
+              'tag': '~emery'},
+}
+
+
+def source_dir(ref, work_dir):
+    """src/c of the working tree, or of `ref` extracted into work_dir."""
+    if not ref:
+        return os.path.join(ROOT, 'src', 'c')
+    top = subprocess.check_output(['git', 'rev-parse', '--show-toplevel'], cwd=ROOT)
+    top = top.decode().strip()
+    prefix = os.path.relpath(os.path.join(ROOT, 'src', 'c'), top)
+    archive = subprocess.check_output(['git', 'archive', ref, prefix], cwd=top)
+    subprocess.run(['tar', '-x', '-C', work_dir], input=archive, check=True)
+    return os.path.join(work_dir, prefix)
+
+
+def build(platform, src, work_dir, pdc=False, profile=False):
+    info = PLATFORMS[platform]
+    flags = ['-DSCREEN_W={}'.format(info['size'][0]), '-DSCREEN_H={}'.format(info['size'][1])]
+    flags += ['-D' + define for define in info['defines']]
+    if pdc:
+        flags.append('-DROUNDY_BACKEND_PDC')
+    if profile:
+        flags.append('-DROUNDY_PROFILE')
+    sources = sorted(os.path.join(src, name) for name in os.listdir(src) if name.endswith('.c'))
+    binary = os.path.join(work_dir, platform)
+    subprocess.run(['gcc', '-std=gnu99', '-O2', '-w', '-I', HOST_DIR, '-I', src] + flags +
+                   [os.path.join(HOST_DIR, 'runtime.c')] + sources + ['-lm', '-o', binary],
+                   check=True)
+    return binary
+
+
+def run(binary, platform, work_dir, pdc=False, **env):
+    environ = dict(os.environ, TZ='UTC')
+    environ.update({key: str(value) for key, value in env.items()})
+    if pdc:
+        sys.path.insert(0, os.path.join(ROOT, 'tools'))
+        import roundy_pdc
+        pdc_dir = os.path.join(work_dir, 'pdc')
+        roundy_pdc.generate(pdc_dir)
+        environ.update(PDC_DIR=pdc_dir, PDC_TAG=PLATFORMS[platform]['tag'] or '')
+    return subprocess.run([binary], env=environ, check=True,
+                          stdout=subprocess.PIPE).stdout.decode()
+
+
+def write_png(pgm_path, png_path):
+    with open(pgm_path, 'rb') as f:
+        data = f.read()
+    header, pixels = data.split(b'\n', 1)
+    _, width, height, _ = header.split()
+    width, height = int(width), int(height)
+    rows = b''.join(b'\0' + pixels[y * width:(y + 1) * width] for y in range(height))
+
+    def chunk(kind, body):
+        return (struct.pack('>I', len(body)) + kind + body +
+                struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff))
+
+    with open(png_path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n' +
+                chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 0, 0, 0, 0)) +
+                chunk(b'IDAT', zlib.compress(rows)) + chunk(b'IEND', b''))
+
+
+def check_pdc(args):
+    if args.pdc and PLATFORMS[args.platform]['tag'] is None:
+        sys.exit('{} is a 1-bit platform, the PDC backend is colour only'.format(args.platform))
+
+
+def cmd_render(args, work_dir):
+    check_pdc(args)
+    binary = build(args.platform, source_dir(args.ref, work_dir), work_dir, pdc=args.pdc,
+                   profile=args.profile)
+    pgm = os.path.join(work_dir, 'frame.pgm')
+    output = run(binary, args.platform, work_dir, pdc=args.pdc, HOST_RUN_MS=args.ms,
+                 HOST_START_SEC=args.start_sec, HOST_OUT=pgm)
+    if args.profile:
+        # the ROUNDY_PROFILE dump, ready for tools/profile_histogram.py
+        sys.stdout.write(output)
+    if args.output.endswith('.pgm'):
+        shutil.copy(pgm, args.output)
+    else:
+        write_png(pgm, args.output)
+    print(args.output)
+
+
+def cmd_bench(args, work_dir):
+    check_pdc(args)
+    refs = [None] + ([args.ref] if args.ref else [])
+    for ref in refs:
+        ref_dir = tempfile.mkdtemp(dir=work_dir)
+        binary = build(args.platform, source_dir(ref, ref_dir), ref_dir, pdc=args.pdc)
+        output = run(binary, args.platform, ref_dir, pdc=args.pdc, HOST_RUN_MS=args.ms,
+                     HOST_START_SEC=args.start_sec, HOST_BENCH=args.frames)
+        for line in output.splitlines():
+            if line.endswith('us/frame') or ' calls: ' in line:
+                print('{:>12}: {}'.format(ref or 'working tree', line))
+
+
+def cmd_startup(args, work_dir):
+    check_pdc(args)
+    refs = [None] + ([args.ref] if args.ref else [])
+    for ref in refs:
+        ref_dir = tempfile.mkdtemp(dir=work_dir)
+        binary = build(args.platform, source_dir(ref, ref_dir), ref_dir, pdc=args.pdc)
+        first_frame = []
+        for _ in range(args.runs):
+            output = run(binary, args.platform, ref_dir, pdc=args.pdc, HOST_RUN_MS=args.ms,
+                         HOST_START_SEC=args.start_sec, HOST_STARTUP=1)
+            lines = [line for line in output.splitlines() if ': ' in line]
+            first_frame.append(float(lines[0].split()[2]))
+        print('{}:'.format(ref or 'working tree'))
+        # host wall clock is noisy (a cold single frame); the counts and simulated milestones
+        # are exact
+        first_frame.sort()
+        print('  first frame: min {:.1f} / median {:.1f} us after window_create ({} runs)'.format(
+            first_frame[0], first_frame[len(first_frame) // 2], args.runs))
+        print('  before it: {}'.format(', '.join(lines[0].split(', ')[1:])))
+        for line in lines[1:]:
+            print('  ' + line)
+
+
+def cmd_ticks(args, work_dir):
+    check_pdc(args)
+    binary = build(args.platform, source_dir(args.ref, work_dir), work_dir, pdc=args.pdc)
+    latencies = {'blit': [], 'drawn': []}
+    for _ in range(args.runs):
+        # starting 1 s before the boundary leaves no time to prerender, so the first tick is
+        # drawn directly and the later ones hit the prerendered band
+        output = run(binary, args.platform, work_dir, pdc=args.pdc,
+                     HOST_RUN_MS=args.minutes * 60000, HOST_START_SEC=59, HOST_TICKS=1)
+        for line in output.splitlines():
+            if line.startswith('tick frame: '):
+                _, _, path, micros, _ = line.split()
+                latencies[path].append(float(micros))
+    for path, values in sorted(latencies.items()):
+        values.sort()
+        if values:
+            print('tick to frame, {}: n={} min={:.1f} median={:.1f} max={:.1f} us'.format(
+                path, len(values), values[0], values[len(values) // 2], values[-1]))
+        else:
+            print('tick to frame, {}: no samples'.format(path))
+
+
+def cmd_insns(args, work_dir):
+    info = PLATFORMS[args.platform]
+    binary = os.path.join(work_dir, 'insns')
+    subprocess.run(['gcc', '-std=gnu99', '-Os', '-I', HOST_DIR, '-I',
+                    os.path.join(ROOT, 'src', 'c'),
+                    '-DSCREEN_W={}'.format(info['size'][0]),
+                    '-DSCREEN_H={}'.format(info['size'][1])] +
+                   ['-D' + define for define in info['defines']] +
+                   [os.path.join(HOST_DIR, 'insns.c'), '-o', binary], check=True)
+    sys.stdout.write(subprocess.check_output([binary]).decode())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest='command')
+    commands.required = True
+
+    render = commands.add_parser('render', help='write the face as PNG (or .pgm)')
+    render.add_argument('--ms', type=int, default=90000, help='simulated run time')
+    render.add_argument('-o', '--output', default='face.png')
+    render.add_argument('--profile', action='store_true',
+                        help='build with ROUNDY_PROFILE and print its dump')
+    render.set_defaults(handler=cmd_render)
+
+    bench = commands.add_parser('bench', help='time the background and digit update procs')
+    bench.add_argument('--ms', type=int, default=90000,
+                       help='simulated run time before timing (default: idle grid)')
+    bench.add_argument('--frames', type=int, default=20000)
+    bench.set_defaults(handler=cmd_bench)
+
+    startup = commands.add_parser('startup', help='first frame and intro milestones')
+    startup.add_argument('--ms', type=int, default=5000, help='simulated run time')
+    startup.add_argument('--runs', type=int, default=9)
+    startup.set_defaults(handler=cmd_startup)
+
+    ticks = commands.add_parser('ticks', help='tick-to-frame latency, blit vs drawn')
+    ticks.add_argument('--minutes', type=int, default=5, help='simulated minutes per run')
+    ticks.add_argument('--runs', type=int, default=9)
+    ticks.set_defaults(handler=cmd_ticks)
+
+    insns = commands.add_parser('insns', help='count instructions per cell, kernel vs loop')
+    insns.set_defaults(handler=cmd_insns)
+
+    for command in (render, bench, startup, ticks, insns):
+        command.add_argument('platform', choices=sorted(PLATFORMS))
+    for command in (render, bench, startup, ticks):
+        command.add_argument('--ref',
+                             help='git ref to build src/c from (bench/startup: also run it to compare)')
+        command.add_argument('--pdc', action='store_true', help='build with ROUNDY_BACKEND=pdc')
+    for command in (render, bench, startup):
+        command.add_argument('--start-sec', type=int, default=30,
+                             help='second of the minute the face starts at')
+
+    args = parser.parse_args()
+    work_dir = tempfile.mkdtemp(prefix='roundy-host-')
+    try:
+        args.handler(args, work_dir)
+    finally:
+        shutil.rmtree(work_dir)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,73 @@
+/* Counts the instructions one cell diagonal costs with the unrolled kernel from
+ * roundy_cell_kernel.h against the plain per-pixel loop it replaced, by single-stepping a child
+ * process. graphics_draw_pixel is an empty stub so only the cell code itself is counted.
+ */
+#include "pebble.h"
+#include "roundy_cell_kernel.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+__attribute__((noinline)) void graphics_draw_pixel(GContext *ctx, GPoint point) {
+  __asm__ volatile("" : : "r"(ctx), "r"(*(int32_t *)&point));
+}
+
+__attribute__((noinline)) static void prv_empty_cell(GContext *ctx, int col, int row,
+                                                     bool flipped) {
+  __asm__ volatile("" : : "r"(ctx), "r"(col), "r"(row), "r"(flipped));
+}
+
+__attribute__((noinline)) static void prv_loop_cell(GContext *ctx, int col, int row,
+                                                    bool flipped) {
+  const GPoint origin = roundy_cell_origin(col, row);
+  for (int idx = 1; idx <= ROUNDY_CELL_SIZE - 2; ++idx) {
+    const int x_idx = flipped ? (ROUNDY_CELL_SIZE - 1 - idx) : idx;
+    graphics_draw_pixel(ctx, GPoint(origin.x + x_idx, origin.y + idx));
+  }
+}
+
+__attribute__((noinline)) static void prv_kernel_cell(GContext *ctx, int col, int row,
+                                                      bool flipped) {
+  roundy_cell_draw_diagonal(ctx, roundy_cell_origin(col, row), flipped);
+}
+
+typedef void (*CellFn)(GContext *, int, int, bool);
+
+static long prv_count(CellFn fn, bool flipped) {
+  const pid_t child = fork();
+  if (child == 0) {
+    ptrace(PTRACE_TRACEME, 0, NULL, NULL);
+    raise(SIGSTOP);
+    fn(NULL, 3, 5, flipped);
+    raise(SIGSTOP);
+    _exit(0);
+  }
+  int status;
+  waitpid(child, &status, 0);
+  long steps = 0;
+  for (;;) {
+    ptrace(PTRACE_SINGLESTEP, child, NULL, NULL);
+    waitpid(child, &status, 0);
+    if (!WIFSTOPPED(status) || WSTOPSIG(status) != SIGTRAP) {
+      break;
+    }
+    ++steps;
+  }
+  kill(child, SIGKILL);
+  waitpid(child, &status, 0);
+  return steps;
+}
+
+int main(void) {
+  const long empty = prv_count(prv_empty_cell, false);
+  for (int flipped = 0; flipped < 2; ++flipped) {
+    printf("cell %dpx %s: loop %ld, kernel %ld instructions\n", ROUNDY_CELL_PX,
+           flipped ? "flipped" : "plain", prv_count(prv_loop_cell, flipped) - empty,
+           prv_count(prv_kernel_cell, flipped) - empty);
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+/* Minimal stand-in for the Pebble SDK header, enough to build the face on the host with
+ * runtime.c. Platform macros (PBL_BW / PBL_COLOR / PBL_PLATFORM_*) and SCREEN_W / SCREEN_H are
+ * passed on the command line by host.py.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef struct { int16_t x, y; } GPoint;
+typedef struct { int16_t w, h; } GSize;
+typedef struct { GPoint origin; GSize size; } GRect;
+typedef union { uint8_t argb; } GColor;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GColorFromRGB(r, g, b) \
+  ((GColor){.argb = (uint8_t)(0xC0 | (((r) >> 6) << 4) | (((g) >> 6) << 2) | ((b) >> 6))})
+#define GColorBlack ((GColor){.argb = 0xC0})
+#define GColorWhite ((GColor){.argb = 0xFF})
+#define GColorClear ((GColor){.argb = 0x00})
+
+#if defined(PBL_BW)
+#define PBL_IF_COLOR_ELSE(a, b) (b)
+#define PBL_IF_BW_ELSE(a, b) (a)
+#else
+#define PBL_IF_COLOR_ELSE(a, b) (a)
+#define PBL_IF_BW_ELSE(a, b) (b)
+#endif
+#define PBL_IF_ROUND_ELSE(a, b) (b)
+
+typedef struct GContext GContext;
+typedef struct Layer Layer;
+typedef struct Window Window;
+typedef struct AppTimer AppTimer;
+typedef struct GBitmap GBitmap;
+typedef struct GDrawCommandImage GDrawCommandImage;
+typedef struct GDrawCommandSequence GDrawCommandSequence;
+typedef struct GDrawCommandFrame GDrawCommandFrame;
+
+typedef enum { GCornerNone } GCornerMask;
+typedef enum { GBitmapFormat1Bit, GBitmapFormat8Bit } GBitmapFormat;
+typedef enum {
+  GCompOpAssign,
+  GCompOpAssignInverted,
+  GCompOpOr,
+  GCompOpAnd,
+  GCompOpClear,
+  GCompOpSet
+} GCompOp;
+typedef enum { SECOND_UNIT = 1, MINUTE_UNIT = 2, HOUR_UNIT = 4, DAY_UNIT = 8 } TimeUnits;
+typedef enum { ACCEL_AXIS_X } AccelAxisType;
+
+typedef void (*LayerUpdateProc)(Layer *, GContext *);
+typedef void (*AppTimerCallback)(void *);
+typedef void (*TickHandler)(struct tm *, TimeUnits);
+typedef void (*AccelTapHandler)(AccelAxisType, int32_t);
+typedef struct {
+  void (*load)(Window *);
+  void (*appear)(Window *);
+  void (*disappear)(Window *);
+  void (*unload)(Window *);
+} WindowHandlers;
+
+enum {
+  RESOURCE_ID_ROUNDY_GRID_PDC = 1,
+  RESOURCE_ID_ROUNDY_GLYPHS_PDC,
+  RESOURCE_ID_ROUNDY_SWEEP_ROWS_PDC,
+  RESOURCE_ID_ROUNDY_SWEEP_COLS_PDC,
+};
+
+void graphics_draw_pixel(GContext *, GPoint);
+void graphics_fill_rect(GContext *, GRect, uint16_t, GCornerMask);
+void graphics_context_set_fill_color(GContext *, GColor);
+void graphics_context_set_stroke_color(GContext *, GColor);
+void graphics_context_set_compositing_mode(GContext *, GCompOp);
+void graphics_context_set_antialiased(GContext *, bool);
+void graphics_draw_bitmap_in_rect(GContext *, const GBitmap *, GRect);
+GBitmap *graphics_capture_frame_buffer(GContext *);
+bool graphics_release_frame_buffer(GContext *, GBitmap *);
+GBitmap *gbitmap_create_blank(GSize, GBitmapFormat);
+void gbitmap_destroy(GBitmap *);
+uint8_t *gbitmap_get_data(const GBitmap *);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *);
+GBitmapFormat gbitmap_get_format(const GBitmap *);
+bool gcolor_equal(GColor, GColor);
+
+Layer *layer_create_with_data(GRect, size_t);
+void *layer_get_data(const Layer *);
+void layer_destroy(Layer *);
+void layer_set_update_proc(Layer *, LayerUpdateProc);
+void layer_mark_dirty(Layer *);
+GRect layer_get_bounds(const Layer *);
+void layer_add_child(Layer *, Layer *);
+Window *window_create(void);
+void window_destroy(Window *);
+Layer *window_get_root_layer(const Window *);
+void window_set_background_color(Window *, GColor);
+void window_set_window_handlers(Window *, WindowHandlers);
+void window_stack_push(Window *, bool);
+
+AppTimer *app_timer_register(uint32_t, AppTimerCallback, void *);
+void app_timer_cancel(AppTimer *);
+void tick_timer_service_subscribe(TimeUnits, TickHandler);
+void tick_timer_service_unsubscribe(void);
+void accel_tap_service_subscribe(AccelTapHandler);
+void accel_tap_service_unsubscribe(void);
+bool clock_is_24h_style(void);
+uint16_t time_ms(time_t *, uint16_t *);
+void app_event_loop(void);
+
+#define APP_LOG_LEVEL_INFO 1
+#define APP_LOG_LEVEL_DEBUG 2
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+void app_log(uint8_t, const char *, int, const char *, ...) __attribute__((format(printf, 4, 5)));
+
+GDrawCommandImage *gdraw_command_image_create_with_resource(uint32_t);
+void gdraw_command_image_destroy(GDrawCommandImage *);
+void gdraw_command_image_draw(GContext *, GDrawCommandImage *, GPoint);
+GDrawCommandSequence *gdraw_command_sequence_create_with_resource(uint32_t);
+void gdraw_command_sequence_destroy(GDrawCommandSequence *);
+GDrawCommandFrame *gdraw_command_sequence_get_frame_by_index(GDrawCommandSequence *, uint32_t);
+void gdraw_command_frame_draw(GContext *, GDrawCommandSequence *, GDrawCommandFrame *, GPoint);
@@ -0,0 +1,639 @@
+/* Host runtime for the face: a simulated clock, timers, tick events, a layer tree rendered into an
+ * in-memory frame buffer (8-bit, or 1-bit on PBL_BW) and a small Pebble Draw Command interpreter.
+ * app_event_loop() is driven by environment variables, see host.py.
+ */
+#include "pebble.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TIMERS 64
+#define MAX_CHILDREN 8
+
+struct GContext {
+  GColor stroke;
+  GColor fill;
+  GCompOp op;
+  bool antialiased;
+};
+
+struct Layer {
+  GRect frame;
+  LayerUpdateProc proc;
+  Layer *children[MAX_CHILDREN];
+  int child_count;
+  void *data;
+};
+
+struct Window {
+  Layer root;
+  WindowHandlers handlers;
+  GColor background;
+};
+
+struct AppTimer {
+  uint64_t due_ms;
+  AppTimerCallback callback;
+  void *context;
+  bool live;
+};
+
+struct GBitmap {
+  GSize size;
+  GBitmapFormat format;
+  uint16_t stride;
+  uint8_t *data;
+  bool owned;
+};
+
+#if defined(PBL_BW)
+#define FB_STRIDE (((SCREEN_W + 31) / 32) * 4)
+static uint8_t s_fb[SCREEN_H][FB_STRIDE] __attribute__((aligned(4)));
+#else
+#define FB_STRIDE SCREEN_W
+static uint8_t s_fb[SCREEN_H][FB_STRIDE] __attribute__((aligned(4)));
+#endif
+
+static GContext s_ctx;
+static Window *s_window;
+static bool s_dirty;
+static struct AppTimer s_timers[MAX_TIMERS];
+static TickHandler s_tick_handler;
+/* minute aligned epoch; HOST_START_SEC picks where in the minute the face starts */
+static uint64_t s_now_ms = 1699999980ull * 1000;
+static long s_frames;
+static long s_pixel_calls;
+/* graphics calls other than pixels, so bench can report the work a frame asks for */
+static long s_fill_calls;
+static long s_blit_calls;
+static long s_draw_commands;
+static double s_start_seconds;
+/* HOST_STARTUP: every frame is kept so the first one matching the final face can be found */
+#define MAX_SNAPSHOTS 512
+static struct {
+  uint64_t at_ms;
+  uint8_t pixels[SCREEN_H][FB_STRIDE];
+} *s_snapshots;
+static int s_snapshot_count;
+static double s_first_frame_us;
+static long s_first_frame_pixel_calls;
+/* face heap (layer data, bitmaps, resources) and timers armed, snapshotted at the first frame */
+static long s_heap_bytes;
+static long s_timers_armed;
+static long s_first_frame_heap_bytes;
+static long s_first_frame_timers_armed;
+/* HOST_TICKS: host time from each minute tick to the end of the frame that answers it */
+static bool s_report_ticks;
+static double s_tick_seconds;
+static long s_tick_blit_calls;
+
+static double prv_seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void prv_put(int x, int y, uint8_t argb) {
+  if (x < 0 || y < 0 || x >= SCREEN_W || y >= SCREEN_H) {
+    return;
+  }
+#if defined(PBL_BW)
+  const uint8_t bit = (uint8_t)(1 << (x % 8));
+  if (argb == 0xFF) {
+    s_fb[y][x / 8] |= bit;
+  } else {
+    s_fb[y][x / 8] &= (uint8_t)~bit;
+  }
+#else
+  s_fb[y][x] = argb;
+#endif
+}
+
+static uint8_t prv_get(int x, int y) {
+#if defined(PBL_BW)
+  return ((s_fb[y][x / 8] >> (x % 8)) & 1) ? 0xFF : 0xC0;
+#else
+  return s_fb[y][x];
+#endif
+}
+
+/* ---- graphics ---- */
+
+void graphics_draw_pixel(GContext *ctx, GPoint p) {
+  s_pixel_calls++;
+  prv_put(p.x, p.y, ctx->stroke.argb);
+}
+
+void graphics_fill_rect(GContext *ctx, GRect r, uint16_t radius, GCornerMask mask) {
+  s_fill_calls++;
+  (void)radius;
+  (void)mask;
+  for (int y = r.origin.y; y < r.origin.y + r.size.h; ++y) {
+    for (int x = r.origin.x; x < r.origin.x + r.size.w; ++x) {
+      prv_put(x, y, ctx->fill.argb);
+    }
+  }
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) { ctx->fill = color; }
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) { ctx->stroke = color; }
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp op) { ctx->op = op; }
+void graphics_context_set_antialiased(GContext *ctx, bool enable) { ctx->antialiased = enable; }
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect r) {
+  s_blit_calls++;
+  for (int y = 0; y < r.size.h && y < bitmap->size.h; ++y) {
+    for (int x = 0; x < r.size.w && x < bitmap->size.w; ++x) {
+      uint8_t argb;
+      if (bitmap->format == GBitmapFormat1Bit) {
+        const bool set = (bitmap->data[y * bitmap->stride + x / 8] >> (x % 8)) & 1;
+        if (ctx->op == GCompOpOr && !set) {
+          continue;
+        }
+        argb = set ? 0xFF : 0xC0;
+      } else {
+        argb = bitmap->data[y * bitmap->stride + x];
+        if (ctx->op == GCompOpSet && (argb >> 6) == 0) {
+          continue;
+        }
+      }
+      prv_put(r.origin.x + x, r.origin.y + y, argb);
+    }
+  }
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  (void)ctx;
+  static GBitmap frame_buffer;
+  frame_buffer.size = GSize(SCREEN_W, SCREEN_H);
+  frame_buffer.format = PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit);
+  frame_buffer.stride = FB_STRIDE;
+  frame_buffer.data = &s_fb[0][0];
+  return &frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *bitmap) {
+  (void)ctx;
+  (void)bitmap;
+  return true;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = calloc(1, sizeof(*bitmap));
+  bitmap->size = size;
+  bitmap->format = format;
+  bitmap->stride = (format == GBitmapFormat1Bit) ? ((size.w + 31) / 32) * 4 : size.w;
+  bitmap->data = calloc(bitmap->stride, size.h);
+  s_heap_bytes += (long)bitmap->stride * size.h;
+  bitmap->owned = true;
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  free(bitmap->data);
+  free(bitmap);
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) { return bitmap->data; }
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) { return bitmap->stride; }
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) { return bitmap->format; }
+bool gcolor_equal(GColor a, GColor b) { return a.argb == b.argb; }
+
+/* ---- layers and windows ---- */
+
+Layer *layer_create_with_data(GRect frame, size_t size) {
+  Layer *layer = calloc(1, sizeof(*layer));
+  layer->frame = frame;
+  layer->data = calloc(1, size);
+  s_heap_bytes += (long)size;
+  return layer;
+}
+
+void *layer_get_data(const Layer *layer) { return layer->data; }
+
+void layer_destroy(Layer *layer) {
+  free(layer->data);
+  free(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc proc) { layer->proc = proc; }
+void layer_mark_dirty(Layer *layer) { (void)layer; s_dirty = true; }
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+void layer_add_child(Layer *parent, Layer *child) {
+  parent->children[parent->child_count++] = child;
+}
+
+Window *window_create(void) {
+  /* the face's init starts here; process and loader start-up stay out of first-frame timing */
+  if (s_start_seconds == 0) {
+    s_start_seconds = prv_seconds();
+  }
+  Window *window = calloc(1, sizeof(*window));
+  window->root.frame = GRect(0, 0, SCREEN_W, SCREEN_H);
+  return window;
+}
+
+void window_destroy(Window *window) { free(window); }
+Layer *window_get_root_layer(const Window *window) { return (Layer *)&window->root; }
+void window_set_background_color(Window *window, GColor color) { window->background = color; }
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  (void)animated;
+  s_window = window;
+  window->handlers.load(window);
+  s_dirty = true;
+}
+
+/* ---- services ---- */
+
+AppTimer *app_timer_register(uint32_t delay_ms, AppTimerCallback callback, void *context) {
+  s_timers_armed++;
+  for (int i = 0; i < MAX_TIMERS; ++i) {
+    if (!s_timers[i].live) {
+      s_timers[i] = (struct AppTimer){s_now_ms + delay_ms, callback, context, true};
+      return &s_timers[i];
+    }
+  }
+  abort();
+}
+
+void app_timer_cancel(AppTimer *timer) { timer->live = false; }
+void tick_timer_service_subscribe(TimeUnits units, TickHandler handler) {
+  (void)units;
+  s_tick_handler = handler;
+}
+void tick_timer_service_unsubscribe(void) {}
+void accel_tap_service_subscribe(AccelTapHandler handler) { (void)handler; }
+void accel_tap_service_unsubscribe(void) {}
+bool clock_is_24h_style(void) { return true; }
+
+uint16_t time_ms(time_t *seconds, uint16_t *millis) {
+  if (seconds) {
+    *seconds = (time_t)(s_now_ms / 1000);
+  }
+  if (millis) {
+    *millis = (uint16_t)(s_now_ms % 1000);
+  }
+  return (uint16_t)(s_now_ms % 1000);
+}
+
+/* the face only asks for the wall clock; keep it on the simulated one */
+time_t time(time_t *out) {
+  const time_t now = (time_t)(s_now_ms / 1000);
+  if (out) {
+    *out = now;
+  }
+  return now;
+}
+
+void app_log(uint8_t level, const char *file, int line, const char *fmt, ...) {
+  (void)level;
+  printf("%s:%d> ", file, line);
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  va_end(args);
+  printf("\n");
+}
+
+/* ---- Pebble Draw Commands ---- */
+
+struct GDrawCommandImage {
+  uint8_t *data;
+};
+
+struct GDrawCommandSequence {
+  uint8_t *data;
+};
+
+static uint8_t *prv_load_resource(uint32_t id) {
+  static const char *names[] = {"", "roundy_grid", "roundy_glyphs", "roundy_sweep_rows",
+                                "roundy_sweep_cols"};
+  const char *dir = getenv("PDC_DIR");
+  const char *tag = getenv("PDC_TAG");
+  if (!dir || id >= sizeof(names) / sizeof(names[0])) {
+    return NULL;
+  }
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s%s.pdc", dir, names[id], tag ? tag : "");
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  const long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  uint8_t *data = malloc((size_t)length);
+  s_heap_bytes += length;
+  if (fread(data, 1, (size_t)length, file) != (size_t)length) {
+    free(data);
+    data = NULL;
+  }
+  fclose(file);
+  return data;
+}
+
+static int16_t prv_read16(const uint8_t *p) { return (int16_t)(p[0] | (p[1] << 8)); }
+
+/* Only what roundy_pdc.py emits: open two-point 45 degree lines and filled rectangles, with the
+ * same hard-pixel rules the procedural path uses. That is an assumption about the firmware
+ * rasterizer, not a model of it, and it only holds with antialiasing off, so anything else aborts.
+ */
+static const uint8_t *prv_draw_command_list(GContext *ctx, const uint8_t *p, GPoint offset) {
+  if (ctx->antialiased) {
+    fprintf(stderr, "draw commands with antialiasing on; the stub only plots hard pixels\n");
+    abort();
+  }
+  const int count = (uint16_t)prv_read16(p);
+  p += 2;
+  s_draw_commands += count;
+  for (int i = 0; i < count; ++i) {
+    const uint8_t stroke = p[2];
+    const uint8_t width = p[3];
+    const uint8_t fill = p[4];
+    const bool open_path = prv_read16(p + 5) & 1;
+    const int points = (uint16_t)prv_read16(p + 7);
+    p += 9;
+    int xs[8];
+    int ys[8];
+    for (int k = 0; k < points && k < 8; ++k) {
+      xs[k] = prv_read16(p + 4 * k) + offset.x;
+      ys[k] = prv_read16(p + 4 * k + 2) + offset.y;
+    }
+    p += 4 * points;
+
+    if (!open_path && (fill >> 6)) {
+      int x0 = xs[0], x1 = xs[0], y0 = ys[0], y1 = ys[0];
+      for (int k = 1; k < points; ++k) {
+        x0 = xs[k] < x0 ? xs[k] : x0;
+        x1 = xs[k] > x1 ? xs[k] : x1;
+        y0 = ys[k] < y0 ? ys[k] : y0;
+        y1 = ys[k] > y1 ? ys[k] : y1;
+      }
+      for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+          prv_put(x, y, fill);
+        }
+      }
+    }
+    if (width && (stroke >> 6)) {
+      for (int k = 0; k + 1 < points; ++k) {
+        const int dx = xs[k + 1] > xs[k] ? 1 : -1;
+        const int dy = ys[k + 1] > ys[k] ? 1 : -1;
+        for (int x = xs[k], y = ys[k];; x += dx, y += dy) {
+          prv_put(x, y, stroke);
+          if (x == xs[k + 1]) {
+            break;
+          }
+        }
+      }
+    }
+  }
+  return p;
+}
+
+GDrawCommandImage *gdraw_command_image_create_with_resource(uint32_t id) {
+  uint8_t *data = prv_load_resource(id);
+  if (!data) {
+    return NULL;
+  }
+  GDrawCommandImage *image = malloc(sizeof(*image));
+  image->data = data;
+  return image;
+}
+
+void gdraw_command_image_destroy(GDrawCommandImage *image) {
+  free(image->data);
+  free(image);
+}
+
+void gdraw_command_image_draw(GContext *ctx, GDrawCommandImage *image, GPoint offset) {
+  /* magic + size, version + reserved + view box */
+  prv_draw_command_list(ctx, image->data + 8 + 6, offset);
+}
+
+GDrawCommandSequence *gdraw_command_sequence_create_with_resource(uint32_t id) {
+  uint8_t *data = prv_load_resource(id);
+  if (!data) {
+    return NULL;
+  }
+  GDrawCommandSequence *sequence = malloc(sizeof(*sequence));
+  sequence->data = data;
+  return sequence;
+}
+
+void gdraw_command_sequence_destroy(GDrawCommandSequence *sequence) {
+  free(sequence->data);
+  free(sequence);
+}
+
+GDrawCommandFrame *gdraw_command_sequence_get_frame_by_index(GDrawCommandSequence *sequence,
+                                                              uint32_t index) {
+  const uint8_t *p = sequence->data + 8;
+  const uint32_t frame_count = (uint16_t)prv_read16(p + 8);
+  if (index >= frame_count) {
+    return NULL;
+  }
+  p += 10;
+  for (uint32_t frame = 0; frame < index; ++frame) {
+    p += 2;
+    const int commands = (uint16_t)prv_read16(p);
+    p += 2;
+    for (int i = 0; i < commands; ++i) {
+      p += 9 + 4 * (uint16_t)prv_read16(p + 7);
+    }
+  }
+  return (GDrawCommandFrame *)p;
+}
+
+void gdraw_command_frame_draw(GContext *ctx, GDrawCommandSequence *sequence,
+                              GDrawCommandFrame *frame, GPoint offset) {
+  (void)sequence;
+  /* skip the frame duration */
+  prv_draw_command_list(ctx, (const uint8_t *)frame + 2, offset);
+}
+
+/* ---- event loop ---- */
+
+static void prv_render(void) {
+  s_frames++;
+  for (int y = 0; y < SCREEN_H; ++y) {
+    for (int x = 0; x < SCREEN_W; ++x) {
+      prv_put(x, y, s_window->background.argb);
+    }
+  }
+  for (int i = 0; i < s_window->root.child_count; ++i) {
+    Layer *layer = s_window->root.children[i];
+    s_ctx.op = GCompOpAssign;
+    /* firmware default: antialiasing is on for colour platforms */
+    s_ctx.antialiased = PBL_IF_COLOR_ELSE(true, false);
+    if (layer->proc) {
+      layer->proc(layer, &s_ctx);
+    }
+  }
+  s_dirty = false;
+
+  if (s_tick_seconds > 0) {
+    /* the digit band is blitted on a prerender hit and drawn cell by cell otherwise */
+    printf("tick frame: %s %.1f us\n", (s_blit_calls > s_tick_blit_calls) ? "blit" : "drawn",
+           (prv_seconds() - s_tick_seconds) * 1e6);
+    s_tick_seconds = 0;
+  }
+  if (s_frames == 1) {
+    s_first_frame_us = (prv_seconds() - s_start_seconds) * 1e6;
+    s_first_frame_pixel_calls = s_pixel_calls;
+    s_first_frame_heap_bytes = s_heap_bytes;
+    s_first_frame_timers_armed = s_timers_armed;
+  }
+  if (s_snapshots && s_snapshot_count < MAX_SNAPSHOTS) {
+    s_snapshots[s_snapshot_count].at_ms = s_now_ms;
+    memcpy(s_snapshots[s_snapshot_count].pixels, s_fb, sizeof(s_fb));
+    s_snapshot_count++;
+  }
+}
+
+/* Fires timers and minute ticks in order until `until_ms`, rendering whenever a layer is dirty. */
+static void prv_run(uint64_t until_ms) {
+  for (;;) {
+    if (s_dirty) {
+      prv_render();
+    }
+    struct AppTimer *next_timer = NULL;
+    for (int i = 0; i < MAX_TIMERS; ++i) {
+      if (s_timers[i].live && (!next_timer || s_timers[i].due_ms < next_timer->due_ms)) {
+        next_timer = &s_timers[i];
+      }
+    }
+    const uint64_t next_tick = (s_now_ms / 60000 + 1) * 60000;
+    const uint64_t next =
+        (next_timer && next_timer->due_ms < next_tick) ? next_timer->due_ms : next_tick;
+    if (next > until_ms) {
+      s_now_ms = until_ms;
+      return;
+    }
+    s_now_ms = next;
+    if (next_timer && next_timer->due_ms == next) {
+      next_timer->live = false;
+      next_timer->callback(next_timer->context);
+    } else if (s_tick_handler) {
+      const time_t now = (time_t)(s_now_ms / 1000);
+      if (s_report_ticks) {
+        s_tick_seconds = prv_seconds();
+        s_tick_blit_calls = s_blit_calls;
+      }
+      s_tick_handler(gmtime(&now), MINUTE_UNIT);
+    }
+  }
+}
+
+static void prv_write_pgm(const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    perror(path);
+    return;
+  }
+  fprintf(file, "P5 %d %d 255\n", SCREEN_W, SCREEN_H);
+  for (int y = 0; y < SCREEN_H; ++y) {
+    for (int x = 0; x < SCREEN_W; ++x) {
+      const uint8_t argb = prv_get(x, y);
+      fputc((((argb >> 4) & 3) + ((argb >> 2) & 3) + (argb & 3)) * 255 / 9, file);
+    }
+  }
+  fclose(file);
+}
+
+/* Times `iterations` calls of one layer's update proc; reports the best of a few rounds so a busy
+ * host does not skew before/after comparisons.
+ */
+static void prv_bench_layer(const char *name, Layer *layer, long iterations) {
+  const long pixels = s_pixel_calls, fills = s_fill_calls, blits = s_blit_calls;
+  const long commands = s_draw_commands;
+  s_ctx.op = GCompOpAssign;
+  s_ctx.antialiased = PBL_IF_COLOR_ELSE(true, false);
+  layer->proc(layer, &s_ctx);
+  printf("%s calls: %ld pixels, %ld fills, %ld blits, %ld draw commands\n", name,
+         s_pixel_calls - pixels, s_fill_calls - fills, s_blit_calls - blits,
+         s_draw_commands - commands);
+
+  double best = 0;
+  for (int round = 0; round < 5; ++round) {
+    const double start = prv_seconds();
+    for (long i = 0; i < iterations; ++i) {
+      s_ctx.op = GCompOpAssign;
+      s_ctx.antialiased = PBL_IF_COLOR_ELSE(true, false);
+      layer->proc(layer, &s_ctx);
+    }
+    const double elapsed = prv_seconds() - start;
+    best = (round == 0 || elapsed < best) ? elapsed : best;
+  }
+  printf("%s update: %.2f us/frame\n", name, best * 1e6 / iterations);
+}
+
+/* The window holds the background layer first and the digit layer above it. */
+static void prv_bench(long iterations) {
+  prv_bench_layer("background", s_window->root.children[0], iterations);
+  if (s_window->root.child_count > 1) {
+    prv_bench_layer("digit", s_window->root.children[1], iterations);
+  }
+}
+
+/* Startup milestones: the first frame in host time since window_create, then in simulated time when the
+ * final face is first on screen and when the last intro frame is drawn.
+ */
+static void prv_report_startup(uint64_t start_ms) {
+  printf("first frame: %.1f us after window_create, %ld pixel calls, %ld heap bytes, "
+         "%ld timers armed\n",
+         s_first_frame_us, s_first_frame_pixel_calls, s_first_frame_heap_bytes,
+         s_first_frame_timers_armed);
+  const int last = s_snapshot_count - 1;
+  int settled = last;
+  while (settled > 0 &&
+         memcmp(s_snapshots[settled - 1].pixels, s_snapshots[last].pixels, sizeof(s_fb)) == 0) {
+    --settled;
+  }
+  int final_face = 0;
+  while (final_face < last &&
+         memcmp(s_snapshots[final_face].pixels, s_snapshots[last].pixels, sizeof(s_fb)) != 0) {
+    ++final_face;
+  }
+  printf("final face first shown: %llu ms\n",
+         (unsigned long long)(s_snapshots[final_face].at_ms - start_ms));
+  printf("intro done: %llu ms (%d frames)\n",
+         (unsigned long long)(s_snapshots[settled].at_ms - start_ms), settled + 1);
+}
+
+__attribute__((constructor)) static void prv_start_clock(void) {
+  const char *start_sec = getenv("HOST_START_SEC");
+  s_now_ms += (uint64_t)(start_sec ? atoi(start_sec) : 30) * 1000;
+  s_report_ticks = getenv("HOST_TICKS") != NULL;
+  if (getenv("HOST_STARTUP")) {
+    s_snapshots = malloc(sizeof(*s_snapshots) * MAX_SNAPSHOTS);
+  }
+}
+
+void app_event_loop(void) {
+  const uint64_t start_ms = s_now_ms;
+  const char *run_ms = getenv("HOST_RUN_MS");
+  prv_run(s_now_ms + (uint64_t)(run_ms ? atoll(run_ms) : 90000));
+  if (s_snapshots) {
+    prv_report_startup(start_ms);
+  }
+  prv_render();
+
+  const char *out = getenv("HOST_OUT");
+  if (out) {
+    prv_write_pgm(out);
+  }
+  const char *bench = getenv("HOST_BENCH");
+  if (bench) {
+    prv_bench(atol(bench));
+  }
+  printf("frames=%ld pixel_calls=%ld\n", s_frames, s_pixel_calls);
+}
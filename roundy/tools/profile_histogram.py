@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Turn a ROUNDY_PROFILE dump into per-frame timing histograms.
+
+Build with `ROUNDY_PROFILE=1 pebble build`, run the face, flick the wrist to
+dump the ring buffer and capture it with `pebble logs > prof.log`. Then:
+
+    tools/profile_histogram.py prof.log
+
+Update procs that run back to back are grouped into one frame; timer and tick
+samples are counted per sweep (a run of timer wake-ups with no gap longer than
+--sweep-gap). Milestone samples (first_frame, sweep_done) carry the time since
+main() and are reported as startup latency instead of being histogrammed; the
+face keeps them outside the ring buffer and repeats them in every dump.
+tick_frame_drawn / tick_frame_blit hold the tick-to-frame latency with and
+without a matching pre-rendered digit band.
+"""
+
+import argparse
+import collections
+import re
+import sys
+
+# keep in sync with RoundyProfileSite in src/c/roundy_profile.h
+SITES = [
+    'background_update',
+    'digit_update',
+    'background_progress_timer',
+    'background_return_timer',
+    'digit_anim_timer',
+    'tick',
+    'first_frame',
+    'sweep_done',
+    'digit_prerender',
+    'tick_frame_drawn',
+    'tick_frame_blit',
+    'intro_timer',
+]
+UPDATE_SITES = {0, 1}
+TIMER_SITES = {2, 3, 4, 11}
+MILESTONE_SITES = {6, 7}
+
+SAMPLE_RE = re.compile(r'\bprof (\d+) (\d+) (\d+)\s*$')
+
+
+def parse(lines):
+    samples = []
+    for line in lines:
+        match = SAMPLE_RE.search(line)
+        if match:
+            site, start, duration = (int(v) for v in match.groups())
+            samples.append((start, site, duration))
+    samples.sort()
+    return samples
+
+
+def group_frames(samples, gap_ms):
+    frames = []
+    current = []
+    last_end = None
+    for start, site, duration in samples:
+        if site not in UPDATE_SITES:
+            continue
+        if current and start > last_end + gap_ms:
+            frames.append(current)
+            current = []
+        current.append((start, site, duration))
+        last_end = start + duration
+    if current:
+        frames.append(current)
+    return frames
+
+
+def group_sweeps(samples, gap_ms):
+    sweeps = []
+    count = 0
+    last_start = None
+    for start, site, _ in samples:
+        if site not in TIMER_SITES:
+            continue
+        if count and start > last_start + gap_ms:
+            sweeps.append(count)
+            count = 0
+        count += 1
+        last_start = start
+    if count:
+        sweeps.append(count)
+    return sweeps
+
+
+def histogram(title, values, bucket_ms):
+    print(title)
+    if not values:
+        print('  (no samples)')
+        return
+    buckets = collections.Counter(v // bucket_ms for v in values)
+    peak = max(buckets.values())
+    for bucket in range(min(buckets), max(buckets) + 1):
+        n = buckets.get(bucket, 0)
+        low = bucket * bucket_ms
+        bar = '#' * max(1 if n else 0, n * 40 // peak)
+        print('  {:5d}-{:<5d} ms {:5d} {}'.format(low, low + bucket_ms - 1, n, bar))
+    ordered = sorted(values)
+    print('  n={} min={} median={} max={}'.format(
+        len(ordered), ordered[0], ordered[len(ordered) // 2], ordered[-1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('log', nargs='?', type=argparse.FileType('r'), default=sys.stdin)
+    parser.add_argument('--bucket', type=int, default=2, help='histogram bucket width (ms)')
+    parser.add_argument('--frame-gap', type=int, default=2,
+                        help='max idle time between update procs of one frame (ms)')
+    parser.add_argument('--sweep-gap', type=int, default=250,
+                        help='max idle time between timer wake-ups of one sweep (ms)')
+    args = parser.parse_args()
+
+    samples = parse(args.log)
+    if not samples:
+        sys.exit('no "prof" samples found')
+
+    frames = group_frames(samples, args.frame_gap)
+    histogram('frame time (sum of update procs)',
+              [sum(d for _, _, d in frame) for frame in frames], args.bucket)
+    for site, name in enumerate(SITES):
+        if site in MILESTONE_SITES:
+            continue
+        histogram(name, [d for _, s, d in samples if s == site], args.bucket)
+
+    sweeps = group_sweeps(samples, args.sweep_gap)
+    for site in sorted(MILESTONE_SITES):
+        marks = [d for _, s, d in samples if s == site]
+        print('startup {}: {}'.format(SITES[site],
+                                      '{} ms after main()'.format(marks[0]) if marks else '-'))
+    print('timer wake-ups per sweep: {}'.format(' '.join(str(n) for n in sweeps) or '-'))
+
+
+if __name__ == '__main__':
+    main()
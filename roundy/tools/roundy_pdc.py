@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""Generate the Pebble Draw Command resources used by the PDC backend.
+
+Called from wscript before the resources are processed, and runnable by hand:
+
+    tools/roundy_pdc.py [--placeholders] [out_dir]
+
+It writes, for every cell size in LAYOUTS, the static diagonal grid
+(PDCI), the glyphs as one PDCS with a frame per glyph, and the flip sweep
+band as two PDCS (one frame per row / per column). Files for chalk and
+emery carry the ~chalk / ~emery resource tags.
+
+package.json lists these files for every colour build, so builds that do
+not use the PDC backend get --placeholders: empty images and sequences of
+a few bytes each that the procedural code never loads.
+"""
+
+import argparse
+import os
+import re
+import struct
+
+# keep in sync with roundy_layout.h
+LAYOUTS = {
+    '': {'cell': 6, 'cols': 24, 'rows': 28},
+    '~chalk': {'cell': 7, 'cols': 26, 'rows': 26},
+    '~emery': {'cell': 8, 'cols': 26, 'rows': 28},
+}
+DIGIT_WIDTH = 4
+DIGIT_HEIGHT = 9
+# keep in sync with roundy_animation.h / roundy_palette.h (GColor8 argb)
+COLOR_CLEAR = 0x00
+COLOR_BLACK = 0xC0
+COLOR_DIM = 0xD5
+COLOR_BRIGHT = 0xFF
+SWEEP_FRAME_MS = 60
+
+GLYPHS_SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             '..', 'src', 'c', 'roundy_glyphs.c')
+
+PATH = 1
+
+
+def path_command(points, stroke, fill, open_path, stroke_width=1):
+    data = struct.pack('<BBBBBHH', PATH, 0, stroke, stroke_width, fill,
+                       1 if open_path else 0, len(points))
+    for x, y in points:
+        data += struct.pack('<hh', x, y)
+    return data
+
+
+def command_list(commands):
+    return struct.pack('<H', len(commands)) + b''.join(commands)
+
+
+def diagonal(x, y, cell, flipped, color):
+    """One cell diagonal, border pixels skipped (see roundy_cell_kernel.h)."""
+    first, last = 1, cell - 2
+    if flipped:
+        points = [(x + cell - 1 - first, y + first), (x + cell - 1 - last, y + last)]
+    else:
+        points = [(x + first, y + first), (x + last, y + last)]
+    return path_command(points, color, COLOR_CLEAR, True)
+
+
+def fill_rect(x, y, w, h):
+    points = [(x, y), (x + w, y), (x + w, y + h), (x, y + h)]
+    return path_command(points, COLOR_CLEAR, COLOR_BLACK, False, stroke_width=0)
+
+
+def pdc_image(size, commands):
+    body = struct.pack('<BBhh', 1, 0, size[0], size[1]) + command_list(commands)
+    return b'PDCI' + struct.pack('<I', len(body)) + body
+
+
+def pdc_sequence(size, frames):
+    body = struct.pack('<BBhhHH', 1, 0, size[0], size[1], 1, len(frames))
+    for commands in frames:
+        body += struct.pack('<H', SWEEP_FRAME_MS) + command_list(commands)
+    return b'PDCS' + struct.pack('<I', len(body)) + body
+
+
+def load_glyphs(path=GLYPHS_SOURCE):
+    """(width, rows) per glyph, in ROUNDY_GLYPHS order."""
+    with open(path) as f:
+        source = f.read()
+    widths = re.findall(r'\.width\s*=\s*(ROUNDY_DIGIT_WIDTH|ROUNDY_DIGIT_COLON_WIDTH)', source)
+    rows = re.findall(r'\.rows\s*=\s*\{([^}]*)\}', source)
+    glyphs = []
+    for width, row_list in zip(widths, rows):
+        glyphs.append((DIGIT_WIDTH if width == 'ROUNDY_DIGIT_WIDTH' else 2,
+                       [int(v, 16) for v in row_list.split(',') if v.strip()]))
+    return glyphs
+
+
+def grid_image(layout):
+    cell, cols, rows = layout['cell'], layout['cols'], layout['rows']
+    commands = [diagonal(c * cell, r * cell, cell, False, COLOR_DIM)
+                for r in range(rows) for c in range(cols)]
+    return pdc_image((cols * cell, rows * cell), commands)
+
+
+def glyph_sequence(layout, glyphs):
+    cell = layout['cell']
+    frames = []
+    for width, rows in glyphs:
+        commands = []
+        for r, mask in enumerate(rows):
+            for c in range(width):
+                if mask & (1 << (width - 1 - c)):
+                    commands.append(fill_rect(c * cell, r * cell, cell, cell))
+                    commands.append(diagonal(c * cell, r * cell, cell, True, COLOR_BRIGHT))
+        frames.append(commands)
+    return pdc_sequence((DIGIT_WIDTH * cell, DIGIT_HEIGHT * cell), frames)
+
+
+def sweep_sequence(layout, vertical):
+    """Frame i is the flipped band at row i (vertical) or column i."""
+    cell, cols, rows = layout['cell'], layout['cols'], layout['rows']
+    frames = []
+    for index in range(rows if vertical else cols):
+        if vertical:
+            cells = [(c, index) for c in range(cols)]
+            commands = [fill_rect(0, index * cell, cols * cell, cell)]
+        else:
+            cells = [(index, r) for r in range(rows)]
+            commands = [fill_rect(index * cell, 0, cell, rows * cell)]
+        commands += [diagonal(c * cell, r * cell, cell, True, COLOR_BRIGHT) for c, r in cells]
+        frames.append(commands)
+    return pdc_sequence((cols * cell, rows * cell), frames)
+
+
+def placeholder_outputs():
+    return {
+        'roundy_grid': pdc_image((0, 0), []),
+        'roundy_glyphs': pdc_sequence((0, 0), []),
+        'roundy_sweep_rows': pdc_sequence((0, 0), []),
+        'roundy_sweep_cols': pdc_sequence((0, 0), []),
+    }
+
+
+def read_file(path):
+    if not os.path.exists(path):
+        return None
+    with open(path, 'rb') as f:
+        return f.read()
+
+
+def generate(out_dir, placeholders=False):
+    """Writes every resource and returns {file name: size in bytes}."""
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+    glyphs = None if placeholders else load_glyphs()
+    sizes = {}
+    for tag, layout in sorted(LAYOUTS.items()):
+        if placeholders:
+            outputs = placeholder_outputs()
+        else:
+            outputs = {
+                'roundy_grid': grid_image(layout),
+                'roundy_glyphs': glyph_sequence(layout, glyphs),
+                'roundy_sweep_rows': sweep_sequence(layout, True),
+                'roundy_sweep_cols': sweep_sequence(layout, False),
+            }
+        for name, data in sorted(outputs.items()):
+            file_name = '{}{}.pdc'.format(name, tag)
+            path = os.path.join(out_dir, file_name)
+            # leave unchanged files alone so waf does not rebuild the resource pack
+            if read_file(path) != data:
+                with open(path, 'wb') as f:
+                    f.write(data)
+            sizes[file_name] = len(data)
+    return sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('out_dir', nargs='?',
+                        default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                             '..', 'resources', 'data'))
+    parser.add_argument('--placeholders', action='store_true',
+                        help='write empty resources for builds without the PDC backend')
+    args = parser.parse_args()
+    for name, size in sorted(generate(args.out_dir, args.placeholders).items()):
+        print('{:32} {:6d} bytes'.format(name, size))
+
+
+if __name__ == '__main__':
+    main()